@@ -10,14 +10,35 @@
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 #include "hardware/gpio.h"
-#include "hardware/pwm.h"
 #include "lib/ssd1306.h"
+#include "lib/ssd1306_ui.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include "semphr.h"
 #include "queue.h"
 #include <stdio.h>
 #include "animacoes.h"
+#include "ocupacao.h"
+#include "buzzer.h"
+#include "diario.h"
+#include "instantaneo.h"
+#include "perfil.h"
+#include "rastreio.h"
+#include "estatico.h"
+#include "console.h"
+#ifdef CREDENCIAIS
+#include "credencial.h"
+#include <stdlib.h>
+#endif
+#ifdef BENCH_DESPACHO
+#include "bench/bench_despacho.h"
+#endif
+#ifdef BENCH_BRILHO
+#include "bench/bench_brilho.h"
+#endif
+#ifdef BENCH_RENDER
+#include "bench/bench_render.h"
+#endif
 
 /* Definições de Hardware */
 #define I2C_PORT i2c1
@@ -34,6 +55,28 @@
 #define MATRIZ_WS2812B 7 // Matriz WS2812B 5x5
 #define MAX_USUARIOS 8   // Máximo de usuários simultâneos
 
+/* Núcleos (máscaras de afinidade; só valem com DOIS_NUCLEOS) */
+#define NUCLEO_ADMISSAO (1u << 0) // IRQ dos botões, entrada, saída, reset e diário
+#define NUCLEO_SAIDAS (1u << 1)   // Display, LED RGB e matriz
+
+/* Renovação da interface. Uma mensagem de evento fica MENSAGEM_MS na tela
+ * antes de voltar ao status. Sem ECONOMIA o status é refeito a cada
+ * MENSAGEM_MS; com ECONOMIA só quando o estado muda e, como garantia contra
+ * falhas no display ou na matriz, a cada BATIMENTO_MS (0: nunca). */
+#define MENSAGEM_MS 1000
+#ifndef BATIMENTO_MS
+#define BATIMENTO_MS 60000
+#endif
+
+/* Diário de eventos: últimos 64 KB da flash */
+#define DIARIO_TAMANHO (64 * 1024)
+#define DIARIO_OFFSET (PICO_FLASH_SIZE_BYTES - DIARIO_TAMANHO)
+#define DIARIO_PRAZO_MS 10000 // Página incompleta vai para a flash após este tempo
+
+/* Instantâneos da ocupação: dois setores logo antes do diário */
+#define INSTANTANEO_TAMANHO (2 * FLASH_OPS_SETOR)
+#define INSTANTANEO_OFFSET (DIARIO_OFFSET - INSTANTANEO_TAMANHO)
+
 /* Estrutura para eventos */
 typedef enum
 {
@@ -41,20 +84,81 @@ typedef enum
     EVENTO_SAIDA
 } EventoTipo;
 
+typedef enum
+{
+    RECUSA_OCUPACAO,   // Sem vaga (entrada) ou ninguém dentro (saída)
+    RECUSA_CREDENCIAL, // Credencial fora da lista de autorizadas
+    RECUSA_PRESENCA    // Credencial já dentro (entrada) ou fora (saída)
+} RecusaMotivo;
+
 typedef struct
 {
     EventoTipo tipo;
+    bool aceito;       // Decisão tomada na ISR (entrada admitida / saída registrada)
+    uint8_t recusa;    // RecusaMotivo, quando não aceito
+    uint16_t usuarios; // Ocupação logo após a decisão
+    uint16_t geracao;  // geracaoReset no momento da decisão
+    RASTREIO_CAMPO(uint16_t seq;) // Sequência do evento no rastreio de latência
 } Evento;
 
+/* Estado publicado para a tarefa de renderização */
+typedef enum
+{
+    MSG_CONTROLE,
+    MSG_ENTRADA,
+    MSG_SAIDA,
+    MSG_CAPACIDADE,
+    MSG_NENHUM_USUARIO,
+    MSG_REINICIADO,
+    MSG_NAO_AUTORIZADO,
+    MSG_JA_DENTRO,
+    MSG_FORA
+} MensagemId;
+
+typedef struct
+{
+    MensagemId mensagem;
+    uint16_t usuarios;
+    AnimacaoId animacao;
+    RASTREIO_CAMPO(uint16_t seq;) // Evento de origem (0: atualização periódica)
+} EstadoTela;
+
+static const char *const MENSAGENS[] = {
+    [MSG_CONTROLE] = "Controle de Acesso",
+    [MSG_ENTRADA] = "Entrada!",
+    [MSG_SAIDA] = "Saida!",
+    [MSG_CAPACIDADE] = "Capacidade Maxima!",
+    [MSG_NENHUM_USUARIO] = "Nenhum usuario!",
+    [MSG_REINICIADO] = "Sistema Reiniciado!",
+    [MSG_NAO_AUTORIZADO] = "Nao autorizado!",
+    [MSG_JA_DENTRO] = "Ja esta dentro!",
+    [MSG_FORA] = "Nao esta dentro!",
+};
+
 /* Variáveis Globais */
 ssd1306_t disp;                       // Display OLED
-SemaphoreHandle_t xDisplayMutex;      // Mutex para display
-SemaphoreHandle_t xMatrixMutex;       // Mutex para matriz WS2812B
-SemaphoreHandle_t xUsuariosMutex;     // Mutex para usuariosAtivos
-SemaphoreHandle_t xContadorSem;       // Semáforo de contagem (entradas)
+uint8_t dispQuadro[SSD1306_BUFSIZE(128, 64)];     // Framebuffer do display (sem heap)
+uint16_t dispEnvio[SSD1306_TX_CAPACITY(128, 64)]; // Buffer frontal lido pelo DMA
+ssd1306_field_t campoMensagem;        // Campo da mensagem (linhas 20 a 35)
+ssd1306_field_t campoContagem;        // Campo "Usuarios: N" (linha 50)
+SemaphoreHandle_t xDisplayFlushSem;   // Semáforo binário (envio DMA do display livre)
 SemaphoreHandle_t xResetSem;          // Semáforo binário (reset)
-QueueHandle_t xEventQueue;            // Fila para eventos de botões
-volatile uint16_t usuariosAtivos = 0; // Contagem de usuários ativos
+QueueHandle_t xEntradaQueue;          // Fila de eventos de entrada (botão A)
+QueueHandle_t xSaidaQueue;            // Fila de eventos de saída (botão B)
+QueueHandle_t xEstadoMailbox;         // Caixa de tamanho 1: último estado a exibir
+ocupacao_t ocupacao;                  // Contagem de usuários ativos (única fonte)
+diario_anel_t anelDiario;             // Eventos a caminho da flash (ISR -> tarefa)
+diario_t diario;                      // Log circular na flash
+flash_ops_t flashDiario;              // Região de flash do diário
+flash_ops_t flashInstantaneo;         // Região de flash dos instantâneos
+TaskHandle_t xDiarioTask;             // Acordada quando há uma página cheia
+perfil_espera_t esperaFlush;          // Tempo esperando o DMA do display liberar
+RASTREIO_SO(volatile uint16_t seqOled;) // Evento cujo quadro está indo para o OLED
+volatile uint32_t eventosDescartados; // Eventos sem vaga na fila (ficam sem retorno)
+volatile uint16_t geracaoReset;       // Incrementada pela ISR a cada reset
+#ifdef CREDENCIAIS
+credencial_t credenciais;             // Autorizadas (flash) e presentes (bitmap)
+#endif
 
 /* Debouncing */
 absolute_time_t ultimoA = 0;
@@ -62,26 +166,6 @@ absolute_time_t ultimoB = 0;
 absolute_time_t ultimoJoystick = 0;
 const uint32_t DEBOUNCE_US = 200000; // 200 ms
 
-/* Configuração do Buzzer */
-#define BUZZER_FREQ 1000 // Frequência do buzzer (1000 Hz)
-void buzzer_beep_curto()
-{
-    pwm_set_enabled(pwm_gpio_to_slice_num(BUZZER), true);
-    vTaskDelay(pdMS_TO_TICKS(100)); // Beep de 100ms
-    pwm_set_enabled(pwm_gpio_to_slice_num(BUZZER), false);
-}
-
-void buzzer_beep_duplo()
-{
-    pwm_set_enabled(pwm_gpio_to_slice_num(BUZZER), true);
-    vTaskDelay(pdMS_TO_TICKS(100)); // Primeiro beep
-    pwm_set_enabled(pwm_gpio_to_slice_num(BUZZER), false);
-    vTaskDelay(pdMS_TO_TICKS(100)); // Pausa
-    pwm_set_enabled(pwm_gpio_to_slice_num(BUZZER), true);
-    vTaskDelay(pdMS_TO_TICKS(100)); // Segundo beep
-    pwm_set_enabled(pwm_gpio_to_slice_num(BUZZER), false);
-}
-
 /* Configuração do LED RGB */
 void set_rgb_color(uint8_t r, uint8_t g, uint8_t b)
 {
@@ -91,42 +175,92 @@ void set_rgb_color(uint8_t r, uint8_t g, uint8_t b)
 }
 
 /* Atualiza LED RGB conforme ocupação */
-void update_rgb_led()
+void update_rgb_led(uint16_t usuarios)
 {
-    if (xSemaphoreTake(xUsuariosMutex, portMAX_DELAY) == pdTRUE)
+    if (usuarios == 0)
     {
-        if (usuariosAtivos == 0)
-        {
-            set_rgb_color(0, 0, 255); // Azul: nenhum usuário
-        }
-        else if (usuariosAtivos <= MAX_USUARIOS - 2)
-        {
-            set_rgb_color(0, 255, 0); // Verde: 1 a 6 usuários
-        }
-        else if (usuariosAtivos == MAX_USUARIOS - 1)
-        {
-            set_rgb_color(255, 255, 0); // Amarelo: 7 usuários
-        }
-        else
-        {
-            set_rgb_color(255, 0, 0); // Vermelho: 8 usuários
-        }
-        xSemaphoreGive(xUsuariosMutex);
+        set_rgb_color(0, 0, 255); // Azul: nenhum usuário
+    }
+    else if (usuarios <= MAX_USUARIOS - 2)
+    {
+        set_rgb_color(0, 255, 0); // Verde: 1 a 6 usuários
+    }
+    else if (usuarios == MAX_USUARIOS - 1)
+    {
+        set_rgb_color(255, 255, 0); // Amarelo: 7 usuários
     }
+    else
+    {
+        set_rgb_color(255, 0, 0); // Vermelho: 8 usuários
+    }
+}
+
+/* Chamado na IRQ do DMA quando o quadro anterior terminou de ir para o display */
+void display_flush_concluido(void *ctx)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    RASTREIO_MARCA(RASTREIO_DISPLAY, seqOled);
+    RASTREIO_SO(seqOled = 0;)
+    xSemaphoreGiveFromISR(xDisplayFlushSem, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
-/* Atualiza display com mutex */
-void update_display(const char *msg, uint16_t count)
+/* Atualiza display (só redesenha e envia os campos que mudaram). Com
+ * 'forcar', envia mesmo sem mudança o que estiver marcado como sujo (no
+ * batimento, o quadro inteiro). Chamado apenas pela tarefa de
+ * renderização, que é dona do display. */
+void update_display(const char *msg, uint16_t count, bool forcar, uint16_t seq)
 {
-    if (xSemaphoreTake(xDisplayMutex, portMAX_DELAY) == pdTRUE)
+    char buffer[32];
+    bool mudou = ssd1306_field_set(&disp, &campoMensagem, msg); // Mensagem
+    snprintf(buffer, sizeof(buffer), "Usuarios: %d", count);
+    mudou |= ssd1306_field_set(&disp, &campoContagem, buffer); // Contagem
+    if (!mudou && !forcar)
+    {
+        return; // Tela já mostra este estado
+    }
+
+    // O desenho acima já se sobrepôs ao envio anterior; aqui só se espera
+    // o DMA liberar o buffer frontal antes de copiar o novo quadro.
+    uint32_t inicioEspera = perfil_agora();
+    if (xSemaphoreTake(xDisplayFlushSem, pdMS_TO_TICKS(100)) != pdTRUE)
+    {
+        ssd1306_flush_abort(&disp); // Envio travado (ex.: NACK)
+    }
+    perfil_espera_fim(&esperaFlush, inicioEspera);
+    RASTREIO_SO(seqOled = seq;)
+    if (!ssd1306_send_data_async(&disp))
     {
-        char buffer[32];
-        ssd1306_fill(&disp, 0);                 // Limpa o display
-        ssd1306_draw_string(&disp, msg, 0, 20); // Mensagem
-        snprintf(buffer, sizeof(buffer), "Usuarios: %d", count);
-        ssd1306_draw_string(&disp, buffer, 5, 50); // Contagem
-        ssd1306_send_data(&disp);                  // Atualiza display
-        xSemaphoreGive(xDisplayMutex);
+        xSemaphoreGive(xDisplayFlushSem); // Nada mudou, nenhum envio iniciado
+    }
+}
+
+/* Publica o estado a exibir. A caixa guarda só o mais recente: se a tarefa
+ * de renderização estiver ocupada, estados intermediários são descartados. */
+void publicar_estado(MensagemId mensagem, uint16_t usuarios, AnimacaoId animacao, uint16_t seq)
+{
+    EstadoTela estado = {mensagem, usuarios, animacao};
+    RASTREIO_SO(estado.seq = seq;)
+    xQueueOverwrite(xEstadoMailbox, &estado);
+}
+
+/* Copia um evento para o anel do diário em RAM (com as interrupções
+ * desligadas). Retorna true quando o anel acaba de completar uma página. */
+static bool anotar_evento(diario_tipo_t tipo, uint16_t usuarios, absolute_time_t agora)
+{
+    diario_evento_t ev = {to_ms_since_boot(agora), tipo, 0, usuarios};
+    diario_anel_por(&anelDiario, &ev);
+    return diario_anel_ocupado(&anelDiario) == DIARIO_EVENTOS_PAGINA && xDiarioTask != NULL;
+}
+
+/* Registra um evento no diário (chamada na ISR). Só copia para o anel em
+ * RAM; a tarefa do diário é acordada quando já há uma página cheia. */
+static void registrar_evento(diario_tipo_t tipo, uint16_t usuarios, absolute_time_t agora,
+                             BaseType_t *xHigherPriorityTaskWoken)
+{
+    if (anotar_evento(tipo, usuarios, agora))
+    {
+        vTaskNotifyGiveFromISR(xDiarioTask, xHigherPriorityTaskWoken);
     }
 }
 
@@ -143,7 +277,21 @@ void gpio_irq_handler(uint gpio, uint32_t events)
         {
             ultimoA = agora;
             evento.tipo = EVENTO_ENTRADA;
-            xQueueSendFromISR(xEventQueue, &evento, &xHigherPriorityTaskWoken);
+            RASTREIO_SO(evento.seq = RASTREIO_INICIO(agora);)
+            evento.aceito = ocupacao_entrar(&ocupacao, &evento.usuarios);
+            evento.recusa = RECUSA_OCUPACAO;
+            evento.geracao = geracaoReset;
+            RASTREIO_MARCA(RASTREIO_OCUPACAO, evento.seq);
+            if (evento.aceito)
+            {
+                instantaneo_atualizar(evento.usuarios);
+            }
+            if (xQueueSendFromISR(xEntradaQueue, &evento, &xHigherPriorityTaskWoken) != pdTRUE)
+            {
+                eventosDescartados++; // A decisão já valeu; só o retorno se perde
+            }
+            registrar_evento(evento.aceito ? DIARIO_ENTRADA : DIARIO_RECUSA_ENTRADA, evento.usuarios, agora,
+                             &xHigherPriorityTaskWoken);
         }
     }
 
@@ -153,7 +301,21 @@ void gpio_irq_handler(uint gpio, uint32_t events)
         {
             ultimoB = agora;
             evento.tipo = EVENTO_SAIDA;
-            xQueueSendFromISR(xEventQueue, &evento, &xHigherPriorityTaskWoken);
+            RASTREIO_SO(evento.seq = RASTREIO_INICIO(agora);)
+            evento.aceito = ocupacao_sair(&ocupacao, &evento.usuarios);
+            evento.recusa = RECUSA_OCUPACAO;
+            evento.geracao = geracaoReset;
+            RASTREIO_MARCA(RASTREIO_OCUPACAO, evento.seq);
+            if (evento.aceito)
+            {
+                instantaneo_atualizar(evento.usuarios);
+            }
+            if (xQueueSendFromISR(xSaidaQueue, &evento, &xHigherPriorityTaskWoken) != pdTRUE)
+            {
+                eventosDescartados++; // A decisão já valeu; só o retorno se perde
+            }
+            registrar_evento(evento.aceito ? DIARIO_SAIDA : DIARIO_RECUSA_SAIDA, evento.usuarios, agora,
+                             &xHigherPriorityTaskWoken);
         }
     }
 
@@ -162,6 +324,14 @@ void gpio_irq_handler(uint gpio, uint32_t events)
         if (absolute_time_diff_us(ultimoJoystick, agora) > DEBOUNCE_US)
         {
             ultimoJoystick = agora;
+            registrar_evento(DIARIO_RESET, ocupacao_ler(&ocupacao), agora, &xHigherPriorityTaskWoken);
+#ifdef CREDENCIAIS
+            credencial_zerar(&credenciais); // Esvazia os presentes junto com a contagem
+#else
+            ocupacao_zerar(&ocupacao);
+#endif
+            instantaneo_atualizar(0);
+            geracaoReset++; // Eventos já na fila passam a ser anteriores ao reset
             xSemaphoreGiveFromISR(xResetSem, &xHigherPriorityTaskWoken);
         }
     }
@@ -169,47 +339,111 @@ void gpio_irq_handler(uint gpio, uint32_t events)
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
-/* Tarefa de Entrada (Botão A) */
+/* Retorno de uma recusa por credencial, na entrada ou na saída */
+static void recusar_credencial(const Evento *evento)
+{
+    bool desconhecida = evento->recusa == RECUSA_CREDENCIAL;
+    MensagemId mensagem = desconhecida ? MSG_NAO_AUTORIZADO : evento->tipo == EVENTO_ENTRADA ? MSG_JA_DENTRO : MSG_FORA;
+    publicar_estado(mensagem, evento->usuarios, ANIM_CONTAGEM, RASTREIO_SEQ(evento->seq));
+    buzzer_tocar(desconhecida ? &BUZZER_CAPACIDADE : &BUZZER_NENHUM);
+}
+
+#ifdef CREDENCIAIS
+/* Entrada ou saída por credencial, pedida no console ("e 1234", "s 0x4d2").
+ * Roda na tarefa do console, presa ao núcleo da ISR dos botões. A busca na
+ * tabela (leituras da flash pelo XIP) vem antes; só a decisão e a cópia
+ * para o anel do diário (do qual a ISR do reset também é produtora) rodam
+ * com as interrupções desligadas, para não se intercalarem com a ISR. */
+static void credencial_evento(EventoTipo tipo, const char *argumentos)
+{
+    char *fim;
+    uint32_t id = strtoul(argumentos, &fim, 0);
+    if (fim == argumentos)
+    {
+        printf("uso: %c <id>\n", tipo == EVENTO_ENTRADA ? 'e' : 's');
+        return;
+    }
+
+    absolute_time_t agora = get_absolute_time();
+    int32_t indice = credencial_buscar(credenciais.tabela, id);
+    Evento evento;
+    evento.tipo = tipo;
+    uint32_t irq = save_and_disable_interrupts();
+    RASTREIO_SO(evento.seq = RASTREIO_INICIO(agora);)
+    credencial_resultado_t r = tipo == EVENTO_ENTRADA ? credencial_entrar(&credenciais, indice, &evento.usuarios)
+                                                      : credencial_sair(&credenciais, indice, &evento.usuarios);
+    RASTREIO_MARCA(RASTREIO_OCUPACAO, evento.seq);
+    evento.aceito = r == CREDENCIAL_ACEITA;
+    evento.recusa = r == CREDENCIAL_DESCONHECIDA ? RECUSA_CREDENCIAL
+                    : r == CREDENCIAL_PRESENCA   ? RECUSA_PRESENCA
+                                                 : RECUSA_OCUPACAO;
+    evento.geracao = geracaoReset;
+    if (evento.aceito)
+    {
+        instantaneo_atualizar(evento.usuarios);
+    }
+    diario_tipo_t tipoDiario = tipo == EVENTO_ENTRADA ? (evento.aceito ? DIARIO_ENTRADA : DIARIO_RECUSA_ENTRADA)
+                                                      : (evento.aceito ? DIARIO_SAIDA : DIARIO_RECUSA_SAIDA);
+    bool paginaCheia = anotar_evento(tipoDiario, evento.usuarios, agora);
+    restore_interrupts(irq);
+
+    if (xQueueSend(tipo == EVENTO_ENTRADA ? xEntradaQueue : xSaidaQueue, &evento, 0) != pdTRUE)
+    {
+        eventosDescartados++;
+    }
+    if (paginaCheia)
+    {
+        xTaskNotifyGive(xDiarioTask);
+    }
+    static const char *const RESULTADOS[] = {
+        [CREDENCIAL_ACEITA] = "aceita",
+        [CREDENCIAL_DESCONHECIDA] = "nao autorizada",
+        [CREDENCIAL_PRESENCA] = "recusada (ja dentro / fora)",
+        [CREDENCIAL_OCUPACAO] = "recusada (lotado)",
+    };
+    printf("credencial %lu: %s, %u dentro\n", (unsigned long)id, RESULTADOS[r], evento.usuarios);
+}
+
+static void comando_entrada(const char *argumentos)
+{
+    credencial_evento(EVENTO_ENTRADA, argumentos);
+}
+
+static void comando_saida(const char *argumentos)
+{
+    credencial_evento(EVENTO_SAIDA, argumentos);
+}
+#endif
+
+/* Evento decidido antes do último reset: a contagem que ele traz já foi
+ * zerada, então o seu retorno não é mostrado */
+static inline bool anterior_ao_reset(const Evento *evento)
+{
+    return evento->geracao != geracaoReset;
+}
+
+/* Tarefa de Entrada (Botão A): a admissão já foi decidida na ISR, aqui só
+ * se dá o retorno visual e sonoro */
 void vTaskEntrada(void *params)
 {
     Evento evento;
     while (true)
     {
-        if (xQueueReceive(xEventQueue, &evento, portMAX_DELAY) == pdTRUE)
+        if (xQueueReceive(xEntradaQueue, &evento, portMAX_DELAY) == pdTRUE && !anterior_ao_reset(&evento))
         {
-            if (evento.tipo == EVENTO_ENTRADA)
+            RASTREIO_MARCA(RASTREIO_FILA, evento.seq);
+            if (evento.aceito)
+            {
+                publicar_estado(MSG_ENTRADA, evento.usuarios, ANIM_ENTRADA, RASTREIO_SEQ(evento.seq)); // Boneco verde
+            }
+            else if (evento.recusa != RECUSA_OCUPACAO)
             {
-                if (xSemaphoreTake(xContadorSem, 0) == pdTRUE)
-                {
-                    if (xSemaphoreTake(xUsuariosMutex, portMAX_DELAY) == pdTRUE)
-                    {
-                        if (usuariosAtivos < MAX_USUARIOS)
-                        {
-                            usuariosAtivos++;
-                            xSemaphoreGive(xUsuariosMutex);
-                            update_display("Entrada!", usuariosAtivos);
-                            update_rgb_led();
-                            anim_entrada(xMatrixMutex); // Boneco verde
-                            // buzzer_beep_curto();
-                        }
-                        else
-                        {
-                            xSemaphoreGive(xContadorSem);
-                            xSemaphoreGive(xUsuariosMutex);
-                            update_display("Capacidade Maxima!", usuariosAtivos);
-                            buzzer_beep_curto();
-                        }
-                    }
-                }
-                else
-                {
-                    update_display("Capacidade Maxima!", usuariosAtivos);
-                    buzzer_beep_curto();
-                }
+                recusar_credencial(&evento);
             }
             else
             {
-                xQueueSendToFront(xEventQueue, &evento, 0); // Devolve evento
+                publicar_estado(MSG_CAPACIDADE, evento.usuarios, ANIM_CONTAGEM, RASTREIO_SEQ(evento.seq));
+                buzzer_tocar(&BUZZER_CAPACIDADE);
             }
         }
     }
@@ -221,81 +455,151 @@ void vTaskSaida(void *params)
     Evento evento;
     while (true)
     {
-        if (xQueueReceive(xEventQueue, &evento, portMAX_DELAY) == pdTRUE)
+        if (xQueueReceive(xSaidaQueue, &evento, portMAX_DELAY) == pdTRUE && !anterior_ao_reset(&evento))
         {
-            if (evento.tipo == EVENTO_SAIDA)
+            RASTREIO_MARCA(RASTREIO_FILA, evento.seq);
+            if (evento.aceito)
             {
-                if (xSemaphoreTake(xUsuariosMutex, portMAX_DELAY) == pdTRUE)
-                {
-                    if (usuariosAtivos > 0)
-                    {
-                        usuariosAtivos--;
-                        xSemaphoreGive(xContadorSem);
-                        xSemaphoreGive(xUsuariosMutex);
-                        update_display("Saida!", usuariosAtivos);
-                        update_rgb_led();
-                        anim_saida(xMatrixMutex); // Boneco vermelho
-                        // buzzer_beep_curto();
-                    }
-                    else
-                    {
-                        xSemaphoreGive(xUsuariosMutex);
-                        update_display("Nenhum usuario!", usuariosAtivos);
-                        buzzer_beep_curto();
-                    }
-                }
+                publicar_estado(MSG_SAIDA, evento.usuarios, ANIM_SAIDA, RASTREIO_SEQ(evento.seq)); // Boneco vermelho
+            }
+            else if (evento.recusa != RECUSA_OCUPACAO)
+            {
+                recusar_credencial(&evento);
             }
             else
             {
-                xQueueSendToFront(xEventQueue, &evento, 0); // Devolve evento
+                publicar_estado(MSG_NENHUM_USUARIO, evento.usuarios, ANIM_CONTAGEM, RASTREIO_SEQ(evento.seq));
+                buzzer_tocar(&BUZZER_NENHUM);
             }
         }
     }
 }
 
-/* Tarefa de Reset (Joystick) */
+/* Tarefa de Reset (Joystick): a contagem já foi zerada na ISR. As filas não
+ * são esvaziadas aqui: um evento admitido depois do reset, e já contado,
+ * perderia o retorno. As tarefas de entrada e saída descartam sozinhas os
+ * anteriores ao reset (anterior_ao_reset). */
 void vTaskReset(void *params)
 {
     while (true)
     {
         if (xSemaphoreTake(xResetSem, portMAX_DELAY) == pdTRUE)
         {
-            // Limpa a fila de eventos
-            xQueueReset(xEventQueue);
-
-            // Reseta o semáforo de contagem
-            if (xSemaphoreTake(xUsuariosMutex, portMAX_DELAY) == pdTRUE)
-            {
-                usuariosAtivos = 0;
-                xSemaphoreGive(xUsuariosMutex);
-            }
-            while (xSemaphoreTake(xContadorSem, 0) == pdTRUE)
-                ; // Esvazia
-            for (int i = 0; i < MAX_USUARIOS; i++)
-            {
-                xSemaphoreGive(xContadorSem); // Repõe MAX_USUARIOS
-            }
+            publicar_estado(MSG_REINICIADO, ocupacao_ler(&ocupacao), ANIM_RESET, 0); // Piscar vermelho
+            buzzer_tocar(&BUZZER_RESET);
+        }
+    }
+}
 
-            update_display("Sistema Reiniciado!", usuariosAtivos);
-            update_rgb_led();
-            buzzer_beep_duplo();
-            anim_reset(xMatrixMutex); // Piscar vermelho
+/* Tarefa do diário (baixa prioridade): passa os eventos do anel para a
+ * flash, uma página por vez, e anexa o instantâneo da ocupação se ele
+ * mudou. Acorda com uma página cheia ou a cada DIARIO_PRAZO_MS. Apagar e
+ * gravar a flash param o XIP com as interrupções desligadas, e bordas nos
+ * botões durante a pausa se perdem. Gravar uma página é curto (~1 ms); o
+ * apagamento do próximo setor, longo, é adiantado para quando o prazo vence
+ * sem nenhum evento novo, e só cai no meio de eventos se o tráfego não
+ * der essa folga até a escrita chegar ao setor. */
+void vTaskDiario(void *params)
+{
+    diario_evento_t eventos[DIARIO_EVENTOS_PAGINA];
+    uint32_t perdidosGravados = 0;
+    while (true)
+    {
+        bool ocioso = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(DIARIO_PRAZO_MS)) == 0; // Prazo vencido
+        uint32_t n;
+        while ((n = diario_anel_tirar(&anelDiario, eventos, DIARIO_EVENTOS_PAGINA)) > 0)
+        {
+            ocioso = false;
+            uint32_t perdidos = anelDiario.perdidos;
+            uint32_t novos = perdidos - perdidosGravados;
+            diario_gravar(&diario, eventos, n, novos > UINT16_MAX ? UINT16_MAX : novos);
+            perdidosGravados = perdidos;
+        }
+        instantaneo_gravar_flash();
+        if (ocioso)
+        {
+            diario_preparar(&diario); // DIARIO_PRAZO_MS sem eventos
         }
     }
 }
 
-/* Tarefa Periódica para Atualizar Status */
+/* Tempo até refazer o status, que já está na tela desde o último desenho */
+static TickType_t espera_status(void)
+{
+#ifdef ECONOMIA
+    return BATIMENTO_MS ? pdMS_TO_TICKS(BATIMENTO_MS) : portMAX_DELAY;
+#else
+    return pdMS_TO_TICKS(MENSAGEM_MS);
+#endif
+}
+
+/* Se o LED RGB e a matriz devem ser refeitos. Com ECONOMIA, a grade de
+ * contagem só é pedida de novo se a contagem mudou, se a matriz mostrou uma
+ * animação desde então ou no batimento. */
+static bool refazer_saidas(const EstadoTela *estado, const EstadoTela *anterior, bool batimento)
+{
+#ifdef ECONOMIA
+    return batimento || estado->animacao != ANIM_CONTAGEM || anterior->animacao != ANIM_CONTAGEM ||
+           estado->usuarios != anterior->usuarios;
+#else
+    return true;
+#endif
+}
+
+/* Tarefa de renderização: única dona do display e do LED RGB; a matriz é
+ * delegada ao motor de animações. O envio assíncrono do display é ligado
+ * aqui para que o IRQ do DMA fique no núcleo desta tarefa.
+ * Desenha sempre o estado mais recente publicado pelas outras tarefas; sem
+ * novidades por MENSAGEM_MS, volta ao status "Controle de Acesso". */
 void vDisplayTask(void *params)
 {
+    EstadoTela estado = {MSG_CONTROLE, 0, ANIM_CONTAGEM};
+    EstadoTela anterior = {MSG_CONTROLE, UINT16_MAX, ANIM_CONTAGEM}; // Último desenhado
+    ssd1306_async_init_with_buffer(&disp, display_flush_concluido, NULL, dispEnvio); // O primeiro quadro já foi enviado no main
     while (true)
     {
-        update_display("Controle de Acesso", usuariosAtivos);
-        update_rgb_led();
-        anim_contagem(usuariosAtivos, xMatrixMutex); // Grade 2x4
-        vTaskDelay(pdMS_TO_TICKS(1000));             // 5 segundos
+        bool batimento = false;
+        TickType_t espera = estado.mensagem == MSG_CONTROLE ? espera_status() : pdMS_TO_TICKS(MENSAGEM_MS);
+        if (xQueueReceive(xEstadoMailbox, &estado, espera) != pdTRUE)
+        {
+            batimento = estado.mensagem == MSG_CONTROLE; // Status já exibido: só renovar
+            estado.mensagem = MSG_CONTROLE;
+            estado.usuarios = ocupacao_ler(&ocupacao);
+            estado.animacao = ANIM_CONTAGEM;
+            RASTREIO_SO(estado.seq = 0;)
+        }
+
+        bool reenviar = false;
+#ifdef ECONOMIA
+        if (batimento)
+        {
+            ssd1306_invalidate(&disp); // Reenvia o quadro inteiro ao OLED
+            reenviar = true;
+        }
+#endif
+
+        update_display(MENSAGENS[estado.mensagem], estado.usuarios, reenviar, RASTREIO_SEQ(estado.seq));
+        if (refazer_saidas(&estado, &anterior, batimento))
+        {
+            update_rgb_led(estado.usuarios);
+            RASTREIO_MARCA(RASTREIO_LED, estado.seq);
+            anim_solicitar(estado.animacao, estado.usuarios, RASTREIO_SEQ(estado.seq)); // Não bloqueia
+        }
+        anterior = estado;
     }
 }
 
+/* Prende a tarefa aos núcleos da máscara no build de dois núcleos */
+static void fixar_nucleo(TaskHandle_t tarefa, UBaseType_t nucleos)
+{
+#ifdef DOIS_NUCLEOS
+    vTaskCoreAffinitySet(tarefa, nucleos);
+#else
+    (void)tarefa;
+    (void)nucleos;
+#endif
+}
+
 /* Função Principal */
 int main()
 {
@@ -307,9 +611,11 @@ int main()
     gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
     gpio_pull_up(I2C_SDA);
     gpio_pull_up(I2C_SCL);
-    ssd1306_init(&disp, 128, 64, false, ENDERECO_OLED, I2C_PORT);
+    ssd1306_init_with_buffer(&disp, 128, 64, false, ENDERECO_OLED, I2C_PORT, dispQuadro);
     ssd1306_config(&disp);
     ssd1306_send_data(&disp);
+    ssd1306_field_init(&campoMensagem, "mensagem", 0, 20, 128, 16);
+    ssd1306_field_init(&campoContagem, "contagem", 5, 50, 123, 8);
 
     /* Configuração dos Botões, LED RGB e Buzzer */
     gpio_init(BOTAO_A);
@@ -331,33 +637,94 @@ int main()
     /* Inicialização da Matriz WS2812B */
     npInit(MATRIZ_WS2812B);
 
-    /* Configuração do PWM para Buzzer */
-    gpio_set_function(BUZZER, GPIO_FUNC_PWM);
-    uint slice_num = pwm_gpio_to_slice_num(BUZZER);
-    pwm_config config = pwm_get_default_config();
-    pwm_config_set_clkdiv(&config, 125.0f);
-    pwm_config_set_wrap(&config, 1000); // ~1000 Hz
-    pwm_init(slice_num, &config, false);
-    pwm_set_gpio_level(BUZZER, 500); // 50% duty cycle
-
-    /* Configuração das Interrupções */
-    gpio_set_irq_enabled_with_callback(BOTAO_A, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
-    gpio_set_irq_enabled(BOTAO_B, GPIO_IRQ_EDGE_FALL, true);
-    gpio_set_irq_enabled(JOYSTICK, GPIO_IRQ_EDGE_FALL, true);
+    /* Sequenciador do buzzer (PWM + alarme de hardware) */
+    buzzer_iniciar(BUZZER);
+
+    /* Diário na flash: retoma após a página mais recente */
+    flash_ops_rp2040(&flashDiario, DIARIO_OFFSET, DIARIO_TAMANHO);
+    diario_abrir(&diario, &flashDiario);
+
+    /* Estado de ocupação (antes das interrupções, que já decidem admissões),
+     * retomado do instantâneo mais recente em RAM ou flash */
+    ocupacao_iniciar(&ocupacao, MAX_USUARIOS);
+    uint32_t inicioRestauro = time_us_32();
+    uint16_t usuariosSalvos;
+    flash_ops_rp2040(&flashInstantaneo, INSTANTANEO_OFFSET, INSTANTANEO_TAMANHO);
+    instantaneo_origem_t origem = instantaneo_restaurar(&flashInstantaneo, &usuariosSalvos);
+#ifdef CREDENCIAIS
+    // O conjunto de presentes não é salvo: uma contagem retomada não teria
+    // credenciais para sair, então a partida começa vazia
+    usuariosSalvos = 0;
+    credencial_iniciar(&credenciais, &CREDENCIAIS_AUTORIZADAS, credenciais_presentes, &ocupacao);
+    console_registrar('e', comando_entrada);
+    console_registrar('s', comando_saida);
+#endif
+    ocupacao_restaurar(&ocupacao, usuariosSalvos);
+    printf("Ocupacao restaurada (%s): %u usuarios em %lu us\n",
+           origem == INSTANTANEO_RAM ? "RAM" : origem == INSTANTANEO_FLASH ? "flash" : "nenhum",
+           usuariosSalvos, (unsigned long)(time_us_32() - inicioRestauro));
 
     /* Criação de Mutexes, Semáforos e Fila */
-    xDisplayMutex = xSemaphoreCreateMutex();                             // Display OLED
-    xMatrixMutex = xSemaphoreCreateMutex();                              // Matriz WS2812B
-    xUsuariosMutex = xSemaphoreCreateMutex();                            // usuariosAtivos
-    xContadorSem = xSemaphoreCreateCounting(MAX_USUARIOS, MAX_USUARIOS); // Entradas
-    xResetSem = xSemaphoreCreateBinary();                                // Reset
-    xEventQueue = xQueueCreate(10, sizeof(Evento));                      // Fila de eventos
+    CRIAR_SEMAFORO_BINARIO(xDisplayFlushSem);                            // Envio DMA do display
+    xSemaphoreGive(xDisplayFlushSem);                                    // Nenhum envio pendente
+    CRIAR_SEMAFORO_BINARIO(xResetSem);                                   // Reset
+    CRIAR_FILA(xEntradaQueue, 10, Evento);                               // Eventos de entrada
+    CRIAR_FILA(xSaidaQueue, 10, Evento);                                 // Eventos de saída
+    CRIAR_FILA(xEstadoMailbox, 1, EstadoTela);                           // Último estado a exibir
+    perfil_registrar_fila(xEntradaQueue, "entrada");
+    perfil_registrar_fila(xSaidaQueue, "saida");
+    perfil_registrar_fila(xEstadoMailbox, "estado");
+    perfil_registrar_espera(&esperaFlush, "flush oled");
+    perfil_registrar_contador(&disp.total_bytes, "bytes i2c oled");
+    perfil_registrar_contador(&flash_ops_bloqueio_us, "us flash s/ irq");
+    publicar_estado(MSG_CONTROLE, ocupacao_ler(&ocupacao), ANIM_CONTAGEM, 0); // Primeiro desenho da matriz e do LED
+
+    /* Configuração das Interrupções, só depois das filas e semáforos que a
+     * ISR usa: uma borda já muda a ocupação e então precisa deles. Com
+     * CREDENCIAIS, entrada e saída vêm do console e os botões A e B ficam
+     * sem efeito. */
+    gpio_set_irq_enabled_with_callback(JOYSTICK, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
+#ifndef CREDENCIAIS
+    gpio_set_irq_enabled(BOTAO_A, GPIO_IRQ_EDGE_FALL, true);
+    gpio_set_irq_enabled(BOTAO_B, GPIO_IRQ_EDGE_FALL, true);
+#endif
 
     /* Criação das Tarefas */
-    xTaskCreate(vTaskEntrada, "EntradaTask", configMINIMAL_STACK_SIZE + 128, NULL, 2, NULL);
-    xTaskCreate(vTaskSaida, "SaidaTask", configMINIMAL_STACK_SIZE + 128, NULL, 2, NULL);
-    xTaskCreate(vTaskReset, "ResetTask", configMINIMAL_STACK_SIZE + 128, NULL, 3, NULL);
-    xTaskCreate(vDisplayTask, "DisplayTask", configMINIMAL_STACK_SIZE + 128, NULL, 1, NULL);
+#ifdef BENCH_DESPACHO
+    bench_despacho_iniciar(); // Benchmark no lugar das tarefas da aplicação
+#elif defined(BENCH_BRILHO)
+    bench_brilho_iniciar(); // Benchmark no lugar das tarefas da aplicação
+#elif defined(BENCH_RENDER)
+    bench_render_iniciar(); // Benchmark no lugar das tarefas da aplicação
+#else
+    TaskHandle_t xEntradaTask, xSaidaTask, xResetTask, xDisplayTask;
+    CRIAR_TAREFA(vTaskEntrada, "EntradaTask", configMINIMAL_STACK_SIZE + 128, NULL, 2, &xEntradaTask);
+    CRIAR_TAREFA(vTaskSaida, "SaidaTask", configMINIMAL_STACK_SIZE + 128, NULL, 2, &xSaidaTask);
+    CRIAR_TAREFA(vTaskReset, "ResetTask", configMINIMAL_STACK_SIZE + 128, NULL, 3, &xResetTask);
+    CRIAR_TAREFA(vDisplayTask, "DisplayTask", configMINIMAL_STACK_SIZE + 128, NULL, 1, &xDisplayTask);
+    TaskHandle_t xAnimTask = anim_iniciar(1); // Tarefa da matriz WS2812B
+    CRIAR_TAREFA(vTaskDiario, "DiarioTask", configMINIMAL_STACK_SIZE + 256, NULL, tskIDLE_PRIORITY + 1, &xDiarioTask);
+
+    /* A IRQ dos botões foi habilitada neste núcleo (0): a admissão fica
+     * com ela e as saídas vão para o outro. A ocupação já é protegida por
+     * spinlock de hardware, válido entre núcleos. */
+    fixar_nucleo(xEntradaTask, NUCLEO_ADMISSAO);
+    fixar_nucleo(xSaidaTask, NUCLEO_ADMISSAO);
+    fixar_nucleo(xResetTask, NUCLEO_ADMISSAO);
+    fixar_nucleo(xDiarioTask, NUCLEO_ADMISSAO);
+    fixar_nucleo(xDisplayTask, NUCLEO_SAIDAS);
+    fixar_nucleo(xAnimTask, NUCLEO_SAIDAS);
+#ifdef PERFIL
+    perfil_iniciar(5000, tskIDLE_PRIORITY + 1); // Relatório na USB a cada 5 s
+#endif
+#ifdef RASTREIO
+    rastreio_iniciar(); // Histogramas de latência sob demanda ('h' e 'z')
+#endif
+#if defined(RASTREIO) || defined(CREDENCIAIS)
+    // No núcleo da ISR: as credenciais são decididas com as interrupções desligadas
+    fixar_nucleo(console_iniciar(tskIDLE_PRIORITY + 1), NUCLEO_ADMISSAO);
+#endif
+#endif
 
     /* Inicia o Escalonador FreeRTOS */
     vTaskStartScheduler();
@@ -0,0 +1,90 @@
+/*
+ * Benchmark do estágio de brilho da matriz (cmake -DBENCH_BRILHO=ON)
+ *
+ * Compara, em ciclos de CPU, a decodificação de um sprite para o buffer
+ * 'leds' em dois caminhos:
+ *   - float: cada canal multiplicado por um float de intensidade, como o
+ *     desenhaSprite original (ponto flutuante emulado no Cortex-M0+);
+ *   - ponto fixo: brilho 8.8 e tabela de gama (desenhaSprite atual).
+ * Os ciclos saem do tempo total de ITERACOES decodificações com as
+ * interrupções desligadas, multiplicado pelo clock do sistema.
+ */
+
+#include "bench_brilho.h"
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "estatico.h"
+#include "sprites.h"
+#include <stdio.h>
+
+#define ITERACOES 10000
+
+// Definidas em lib/matrizled.c, incluída pelo programa principal
+int getIndex(int x, int y);
+void npSetLED(const uint index, const uint8_t r, const uint8_t g, const uint8_t b);
+void npSetBrilho(uint16_t brilho);
+void desenhaSprite(const sprite_t *sprite, const cor_t *paleta);
+
+// Caminho de referência: o desenhaSprite anterior, com intensidade em float
+static void __attribute__((noinline)) desenhaSpriteFloat(const sprite_t *sprite, const cor_t *paleta, float intensidade)
+{
+    for (int i = 0; i < SPRITE_PIXELS; i++)
+    {
+        const cor_t *c = &paleta[sprite_indice(sprite, i)];
+        npSetLED(getIndex(i % SPRITE_LADO, i / SPRITE_LADO), (int)(c->r * intensidade),
+                 (int)(c->g * intensidade), (int)(c->b * intensidade));
+    }
+}
+
+// Ciclos por sprite a partir do tempo total das ITERACOES
+static uint32_t ciclos(uint32_t tempo_us)
+{
+    return (uint32_t)((uint64_t)tempo_us * (clock_get_hz(clk_sys) / 1000000) / ITERACOES);
+}
+
+static void medir(void)
+{
+    volatile float intensidade = 0.5f; // Não deixa o compilador dobrar a constante
+    const sprite_t *sprite = &BONECO[4];
+
+    uint32_t irq = save_and_disable_interrupts();
+
+    uint32_t inicio = time_us_32();
+    for (int i = 0; i < ITERACOES; i++)
+        desenhaSpriteFloat(sprite, PALETA_VERDE, intensidade);
+    uint32_t tempoFloat = time_us_32() - inicio;
+
+    npSetBrilho(0x0080); // 0,5 em 8.8
+    inicio = time_us_32();
+    for (int i = 0; i < ITERACOES; i++)
+        desenhaSprite(sprite, PALETA_VERDE);
+    uint32_t tempoFixo = time_us_32() - inicio;
+    npSetBrilho(0x0100);
+
+    restore_interrupts(irq);
+
+    uint32_t cf = ciclos(tempoFloat), cx = ciclos(tempoFixo);
+    printf("\nBenchmark de brilho: sprite 5x5, %d iteracoes\n", ITERACOES);
+    printf("%-12s %6lu ciclos/sprite  %4lu ciclos/canal\n", "float", (unsigned long)cf,
+           (unsigned long)(cf / (SPRITE_PIXELS * 3)));
+    printf("%-12s %6lu ciclos/sprite  %4lu ciclos/canal\n", "ponto fixo", (unsigned long)cx,
+           (unsigned long)(cx / (SPRITE_PIXELS * 3)));
+}
+
+static void vBenchBrilho(void *params)
+{
+    vTaskDelay(pdMS_TO_TICKS(3000)); // Tempo para o terminal USB conectar
+    while (true)
+    {
+        medir();
+        vTaskDelay(pdMS_TO_TICKS(5000));
+    }
+}
+
+void bench_brilho_iniciar(void)
+{
+    CRIAR_TAREFA(vBenchBrilho, "BenchBrilho", configMINIMAL_STACK_SIZE + 256, NULL, 1, NULL);
+}
@@ -0,0 +1,8 @@
+#ifndef BENCH_BRILHO_H
+#define BENCH_BRILHO_H
+
+// Cria a tarefa do benchmark do estágio de brilho da matriz. Deve ser
+// chamada antes de vTaskStartScheduler, no lugar das tarefas da aplicação.
+void bench_brilho_iniciar(void);
+
+#endif /* BENCH_BRILHO_H */
@@ -0,0 +1,133 @@
+/*
+ * Benchmark de despacho de eventos (cmake -DBENCH_DESPACHO=ON)
+ *
+ * Mede trocas de contexto e tempo por evento sob rajadas de eventos mistos
+ * de entrada/saída em dois esquemas:
+ *   - fila única: os dois consumidores leem a mesma fila e devolvem com
+ *     xQueueSendToFront o evento do outro tipo (esquema original);
+ *   - filas por tipo: o produtor entrega cada evento direto ao consumidor.
+ * O produtor roda com prioridade acima dos consumidores, como a ISR dos
+ * botões, e os consumidores têm a mesma prioridade de vTaskEntrada/vTaskSaida.
+ * As trocas são contadas pelo traceTASK_SWITCHED_IN do FreeRTOSConfig.h.
+ */
+
+#include "bench_despacho.h"
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "estatico.h"
+#include <stdio.h>
+
+#define RAJADA 10   // Eventos por rajada (capacidade da fila da aplicação)
+#define RODADAS 200 // Rajadas por esquema
+
+volatile uint32_t ulTrocasDeContexto = 0;
+
+static QueueHandle_t xFilaUnica;
+static QueueHandle_t xFilaEntrada;
+static QueueHandle_t xFilaSaida;
+static TaskHandle_t xProdutor;
+static uint32_t processados;
+
+// Conta um evento tratado e acorda o produtor ao fim da rajada
+static void concluir(void)
+{
+    bool fim;
+    taskENTER_CRITICAL();
+    fim = (++processados == RAJADA);
+    taskEXIT_CRITICAL();
+    if (fim)
+    {
+        xTaskNotifyGive(xProdutor);
+    }
+}
+
+// Consumidor do esquema original: devolve eventos que não são do seu tipo
+static void vConsumidorFilaUnica(void *params)
+{
+    uint8_t meuTipo = (uint8_t)(uintptr_t)params;
+    uint8_t tipo;
+    while (true)
+    {
+        if (xQueueReceive(xFilaUnica, &tipo, portMAX_DELAY) == pdTRUE)
+        {
+            if (tipo == meuTipo)
+            {
+                concluir();
+            }
+            else
+            {
+                xQueueSendToFront(xFilaUnica, &tipo, 0); // Devolve evento
+            }
+        }
+    }
+}
+
+// Consumidor do esquema roteado: só recebe eventos do seu tipo
+static void vConsumidorRoteado(void *params)
+{
+    QueueHandle_t fila = (QueueHandle_t)params;
+    uint8_t tipo;
+    while (true)
+    {
+        if (xQueueReceive(fila, &tipo, portMAX_DELAY) == pdTRUE)
+        {
+            concluir();
+        }
+    }
+}
+
+static void medir(const char *nome, bool roteado)
+{
+    uint32_t trocas = 0;
+    uint32_t tempo_us = 0;
+
+    for (int r = 0; r < RODADAS; r++)
+    {
+        processados = 0;
+        uint32_t trocasInicio = ulTrocasDeContexto;
+        uint32_t inicio = time_us_32();
+
+        for (uint8_t i = 0; i < RAJADA; i++)
+        {
+            uint8_t tipo = i & 1; // Entrada e saída alternadas
+            QueueHandle_t fila = roteado ? (tipo ? xFilaSaida : xFilaEntrada) : xFilaUnica;
+            xQueueSend(fila, &tipo, 0);
+        }
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        tempo_us += time_us_32() - inicio;
+        trocas += ulTrocasDeContexto - trocasInicio;
+    }
+
+    uint32_t eventos = RODADAS * RAJADA;
+    printf("%-14s %6lu eventos  %5lu.%02lu trocas/evento  %5lu us/evento\n", nome,
+           (unsigned long)eventos, (unsigned long)(trocas / eventos),
+           (unsigned long)((trocas % eventos) * 100 / eventos), (unsigned long)(tempo_us / eventos));
+}
+
+static void vProdutor(void *params)
+{
+    vTaskDelay(pdMS_TO_TICKS(3000)); // Tempo para o terminal USB conectar
+    while (true)
+    {
+        printf("\nBenchmark de despacho: rajadas de %d eventos mistos\n", RAJADA);
+        medir("fila unica", false);
+        medir("filas por tipo", true);
+        vTaskDelay(pdMS_TO_TICKS(5000));
+    }
+}
+
+void bench_despacho_iniciar(void)
+{
+    CRIAR_FILA(xFilaUnica, RAJADA, uint8_t);
+    CRIAR_FILA(xFilaEntrada, RAJADA, uint8_t);
+    CRIAR_FILA(xFilaSaida, RAJADA, uint8_t);
+
+    CRIAR_TAREFA(vProdutor, "BenchProdutor", configMINIMAL_STACK_SIZE + 256, NULL, 3, &xProdutor);
+    CRIAR_TAREFA(vConsumidorFilaUnica, "BenchUnicaE", configMINIMAL_STACK_SIZE, (void *)0, 2, NULL);
+    CRIAR_TAREFA(vConsumidorFilaUnica, "BenchUnicaS", configMINIMAL_STACK_SIZE, (void *)1, 2, NULL);
+    CRIAR_TAREFA(vConsumidorRoteado, "BenchRotE", configMINIMAL_STACK_SIZE, xFilaEntrada, 2, NULL);
+    CRIAR_TAREFA(vConsumidorRoteado, "BenchRotS", configMINIMAL_STACK_SIZE, xFilaSaida, 2, NULL);
+}
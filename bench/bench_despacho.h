@@ -0,0 +1,8 @@
+#ifndef BENCH_DESPACHO_H
+#define BENCH_DESPACHO_H
+
+// Cria as tarefas do benchmark de despacho de eventos. Deve ser chamada
+// antes de vTaskStartScheduler, no lugar das tarefas da aplicação.
+void bench_despacho_iniciar(void);
+
+#endif /* BENCH_DESPACHO_H */
@@ -0,0 +1,317 @@
+/*
+ * Benchmark das primitivas de renderização (cmake -DBENCH_RENDER=ON na
+ * placa; no PC, o alvo bench_render de host/CMakeLists.txt)
+ *
+ * Mede ssd1306_fill, ssd1306_draw_string, ssd1306_line, desenhaSprite,
+ * getIndex e npWrite. Cada operação é cronometrada sozinha, com as
+ * interrupções desligadas, e o custo de ler o relógio é descontado:
+ *   - na placa, pelo SysTick, que o port do FreeRTOS faz contar ciclos do
+ *     clk_sys e recarrega a cada tick (nenhuma operação chega a 1 ms);
+ *   - no PC, por clock_gettime, com o I2C e a PIO trocados pelos
+ *     substitutos em memória de host/shims. Não há ciclos, só ns.
+ *
+ * Quadros de referência: depois de cada série, o CRC-32 do que ela produziu
+ * (framebuffer do OLED, buffer 'leds', posições do mapa ou palavras
+ * entregues à PIO) é comparado com o valor gravado em CASOS, tirado do
+ * build do PC. Uma otimização que mude o desenho aparece como FALHOU.
+ */
+
+#include "bench_render.h"
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "ssd1306.h"
+#include "sprites.h"
+#include "matriz_mapa.h"
+#include "crc32.h"
+#include <stdio.h>
+
+#if PICO_ON_DEVICE
+#include "hardware/structs/systick.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "estatico.h"
+#else
+#include "pico_sim.h"
+#include <time.h>
+#endif
+
+// Definidas em lib/matrizled.c (incluída pelo programa principal na placa)
+struct pixel_t
+{
+    uint8_t G, R, B;
+};
+extern struct pixel_t leds[NP_PIXELS];
+int getIndex(int x, int y);
+void npSetBrilho(uint16_t brilho);
+void npWrite(void);
+void desenhaSprite(const sprite_t *sprite, const cor_t *paleta);
+
+// Envio de um quadro da matriz mais o RESET, com folga (ver matrizled.c)
+#define ESPERA_MATRIZ_US (NP_PIXELS * 30 + 100 + 50)
+
+// ---------------------------------------------------------------------------
+// Relógio
+// ---------------------------------------------------------------------------
+
+#if PICO_ON_DEVICE
+typedef uint32_t marca_t;
+
+static inline marca_t marca(void)
+{
+    return systick_hw->cvr;
+}
+
+// Ciclos entre duas marcas. O SysTick conta para baixo e volta a RVR.
+static inline uint32_t decorrido(marca_t inicio, marca_t fim)
+{
+    return inicio >= fim ? inicio - fim : inicio + systick_hw->rvr + 1 - fim;
+}
+#else
+typedef uint64_t marca_t;
+
+static inline marca_t marca(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Nanossegundos entre duas marcas
+static inline uint32_t decorrido(marca_t inicio, marca_t fim)
+{
+    return (uint32_t)(fim - inicio);
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// Casos
+// ---------------------------------------------------------------------------
+
+static ssd1306_t tela;    // Só o framebuffer: nada é enviado ao display
+static volatile int soma; // Impede que o compilador descarte getIndex
+
+static uint32_t crc_tela(void)
+{
+    return crc32(tela.ram_buffer, tela.bufsize);
+}
+
+static uint32_t crc_leds(void)
+{
+    return crc32(leds, sizeof(leds));
+}
+
+static void limpar_tela(void)
+{
+    ssd1306_fill(&tela, false);
+}
+
+static void op_fill(uint32_t i)
+{
+    ssd1306_fill(&tela, true);
+}
+
+static void op_string(uint32_t i)
+{
+    ssd1306_draw_string(&tela, "Usuarios: 8", 5, 50);
+}
+
+static void op_line(uint32_t i)
+{
+    ssd1306_line(&tela, 0, 0, 127, 63, true);
+}
+
+static void preparar_sprite(void)
+{
+    npSetBrilho(0x0100);
+}
+
+static void op_sprite(uint32_t i)
+{
+    desenhaSprite(&BONECO[4], PALETA_VERDE);
+}
+
+static void op_indice(uint32_t i)
+{
+    soma += getIndex(i % NP_LARGURA, (i / NP_LARGURA) % NP_ALTURA);
+}
+
+static uint32_t crc_mapa(void)
+{
+    uint32_t crc = 0;
+    for (int y = 0; y < NP_ALTURA; y++)
+    {
+        for (int x = 0; x < NP_LARGURA; x++)
+        {
+            uint16_t p = getIndex(x, y);
+            crc = crc32_atualizar(crc, &p, sizeof(p));
+        }
+    }
+    return crc;
+}
+
+static void preparar_write(void)
+{
+    npSetBrilho(0x0100);
+    desenhaSprite(&BONECO[4], PALETA_VERDE);
+}
+
+static void op_write(uint32_t i)
+{
+    npWrite();
+}
+
+// O alarme do latch libera o próximo quadro; no PC ele só dispara quando
+// o "hardware" simulado é atendido
+static void esperar_matriz(void)
+{
+    sleep_us(ESPERA_MATRIZ_US);
+#if !PICO_ON_DEVICE
+    sim_interrupcoes();
+#endif
+}
+
+#if PICO_ON_DEVICE
+#define crc_quadro_pio NULL // A FIFO da PIO não é legível de volta
+#else
+static uint32_t crc_quadro_pio(void)
+{
+    uint n;
+    const uint32_t *quadro = sim_pio_ultimo_quadro(&n);
+    return quadro ? crc32(quadro, n * sizeof(uint32_t)) : 0;
+}
+#endif
+
+// As referências valem para a geometria padrão da BitDogLab (matriz_mapa.h)
+#if NP_PIXELS == 25 && NP_SERPENTINA && NP_ROTACAO == 180
+#define REF_MATRIZ(crc) (crc)
+#else
+#define REF_MATRIZ(crc) 0
+#endif
+
+typedef struct
+{
+    const char *nome;
+    uint32_t repeticoes;
+    void (*preparar)(void);      // Antes da série (NULL: nada)
+    void (*operacao)(uint32_t i);
+    void (*depois)(void);        // Depois de cada operação, fora da medição
+    uint32_t (*resultado)(void); // CRC do que a série produziu (NULL: sem conferência)
+    uint32_t referencia;         // 0: sem referência para este build
+} bench_caso_t;
+
+static const bench_caso_t CASOS[] = {
+    {"ssd1306_fill", 1000, NULL, op_fill, NULL, crc_tela, 0xFCF4B9DC},
+    {"ssd1306_draw_string", 1000, limpar_tela, op_string, NULL, crc_tela, 0x996839C5},
+    {"ssd1306_line", 1000, limpar_tela, op_line, NULL, crc_tela, 0xA68BE25C},
+    {"desenhaSprite", 10000, preparar_sprite, op_sprite, NULL, crc_leds, REF_MATRIZ(0x5F4B0147)},
+    {"getIndex", 100000, NULL, op_indice, NULL, crc_mapa, REF_MATRIZ(0xCF3CC6F6)},
+    {"npWrite", 200, preparar_write, op_write, esperar_matriz, crc_quadro_pio, REF_MATRIZ(0x763176A2)},
+};
+
+// ---------------------------------------------------------------------------
+// Execução
+// ---------------------------------------------------------------------------
+
+// Custo de ler o relógio duas vezes, descontado de cada medida
+static uint32_t medir_sobrecusto(void)
+{
+    uint32_t minimo = UINT32_MAX;
+    for (int i = 0; i < 100; i++)
+    {
+        marca_t a = marca();
+        marca_t b = marca();
+        uint32_t d = decorrido(a, b);
+        minimo = d < minimo ? d : minimo;
+    }
+    return minimo;
+}
+
+// Total das operações da série, em ciclos (placa) ou ns (PC)
+static uint64_t executar_caso(const bench_caso_t *c, uint32_t sobrecusto)
+{
+    uint64_t total = 0;
+    if (c->preparar)
+    {
+        c->preparar();
+    }
+    for (uint32_t i = 0; i < c->repeticoes; i++)
+    {
+        uint32_t irq = save_and_disable_interrupts();
+        marca_t a = marca();
+        c->operacao(i);
+        marca_t b = marca();
+        restore_interrupts(irq);
+
+        uint32_t d = decorrido(a, b);
+        total += d > sobrecusto ? d - sobrecusto : 0;
+        if (c->depois)
+        {
+            c->depois();
+        }
+    }
+    return total;
+}
+
+uint32_t bench_render_executar(void)
+{
+    if (tela.ram_buffer == NULL && !ssd1306_init(&tela, 128, 64, false, 0x3C, i2c1))
+    {
+        printf("Sem memoria para o framebuffer\n");
+        return 1;
+    }
+
+    uint32_t falhas = 0;
+    uint32_t sobrecusto = medir_sobrecusto();
+    printf("\nBenchmark de renderizacao (%s)\n", PICO_ON_DEVICE ? "SysTick" : "PC");
+    printf("%-20s %7s %10s %10s  %s\n", "primitiva", "repet.", "ns/op", "ciclos/op", "quadro");
+
+    for (size_t k = 0; k < count_of(CASOS); k++)
+    {
+        const bench_caso_t *c = &CASOS[k];
+        uint64_t total = executar_caso(c, sobrecusto);
+
+#if PICO_ON_DEVICE
+        uint32_t mhz = clock_get_hz(clk_sys) / 1000000;
+        printf("%-20s %7lu %10.1f %10.1f  ", c->nome, (unsigned long)c->repeticoes,
+               (double)total * 1000 / mhz / c->repeticoes, (double)total / c->repeticoes);
+#else
+        printf("%-20s %7lu %10.1f %10s  ", c->nome, (unsigned long)c->repeticoes,
+               (double)total / c->repeticoes, "-");
+#endif
+
+        if (c->resultado == NULL || c->referencia == 0)
+        {
+            printf("-\n");
+            continue;
+        }
+        uint32_t crc = c->resultado();
+        if (crc == c->referencia)
+        {
+            printf("ok\n");
+        }
+        else
+        {
+            printf("FALHOU (crc %08lx, esperado %08lx)\n", (unsigned long)crc, (unsigned long)c->referencia);
+            falhas++;
+        }
+    }
+    return falhas;
+}
+
+#if PICO_ON_DEVICE
+static void vBenchRender(void *params)
+{
+    vTaskDelay(pdMS_TO_TICKS(3000)); // Tempo para o terminal USB conectar
+    while (true)
+    {
+        bench_render_executar();
+        vTaskDelay(pdMS_TO_TICKS(5000));
+    }
+}
+
+void bench_render_iniciar(void)
+{
+    CRIAR_TAREFA(vBenchRender, "BenchRender", configMINIMAL_STACK_SIZE + 256, NULL, 1, NULL);
+}
+#endif
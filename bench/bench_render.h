@@ -0,0 +1,15 @@
+#ifndef BENCH_RENDER_H
+#define BENCH_RENDER_H
+
+#include <stdint.h>
+
+// Roda uma vez todos os casos do benchmark de renderização, imprime a
+// tabela e retorna quantos resultados divergiram dos quadros de referência.
+// A matriz já deve ter passado por npInit.
+uint32_t bench_render_executar(void);
+
+// Cria a tarefa do benchmark de renderização. Deve ser chamada antes de
+// vTaskStartScheduler, no lugar das tarefas da aplicação.
+void bench_render_iniciar(void);
+
+#endif /* BENCH_RENDER_H */
@@ -0,0 +1,119 @@
+/*
+ * Benchmark da validação de credenciais (lib/credencial.c) no PC.
+ *
+ * A tabela vem de tools/gerar_credenciais.py com 100 mil IDs sorteados e a
+ * opção --teste, que inclui os próprios IDs e outros tantos fora da lista.
+ * Mede o tempo médio de credencial_buscar com e sem sucesso e o de um par
+ * entrada/saída, confere que toda autorizada é achada na sua posição e
+ * nenhuma ausente é aceita, e imprime o pior caso de comparações, que vem
+ * do maior balde gravado pelo gerador e vale igual na placa.
+ *
+ * Uso: bench_credenciais [repeticoes]
+ */
+
+#include "credencial.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+extern const uint32_t CREDENCIAIS_TESTE_N;
+extern const uint32_t CREDENCIAIS_TESTE_IDS[];
+extern const uint32_t CREDENCIAIS_TESTE_AUSENTES[];
+
+static volatile int32_t soma; // Impede que o compilador descarte as buscas
+
+static uint64_t agora_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// ns por busca sobre todos os IDs de 'ids', 'repeticoes' vezes
+static double medir(const uint32_t *ids, uint32_t n, uint32_t repeticoes)
+{
+    const credencial_tabela_t *t = &CREDENCIAIS_AUTORIZADAS;
+    uint64_t inicio = agora_ns();
+    for (uint32_t r = 0; r < repeticoes; r++)
+    {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            soma += credencial_buscar(t, ids[i]);
+        }
+    }
+    return (double)(agora_ns() - inicio) / ((double)n * repeticoes);
+}
+
+// Comparações da busca binária no pior balde
+static uint32_t passos_pior_caso(uint32_t maior_balde)
+{
+    uint32_t passos = 0;
+    while (maior_balde)
+    {
+        maior_balde >>= 1;
+        passos++;
+    }
+    return passos;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t repeticoes = argc > 1 ? strtoul(argv[1], NULL, 0) : 20;
+    const credencial_tabela_t *t = &CREDENCIAIS_AUTORIZADAS;
+    uint32_t n = CREDENCIAIS_TESTE_N;
+    uint32_t falhas = 0;
+
+    // Conferência: a chave achada é a do ID, e nenhuma ausente passa
+    for (uint32_t i = 0; i < n; i++)
+    {
+        int32_t k = credencial_buscar(t, CREDENCIAIS_TESTE_IDS[i]);
+        if (k < 0 || t->chaves[k] != credencial_chave(CREDENCIAIS_TESTE_IDS[i]))
+        {
+            falhas++;
+        }
+        if (credencial_buscar(t, CREDENCIAIS_TESTE_AUSENTES[i]) >= 0)
+        {
+            falhas++;
+        }
+    }
+
+    printf("\nCredenciais: %lu autorizadas, %u baldes (maior com %u chaves)\n", (unsigned long)t->n,
+           1u << t->bits_balde, t->maior_balde);
+    printf("tabela em flash: %lu bytes, presentes em RAM: %lu bytes\n",
+           (unsigned long)((t->n + (1u << t->bits_balde) + 1) * sizeof(uint32_t)),
+           (unsigned long)((t->n + 31) / 32 * sizeof(uint32_t)));
+    printf("pior caso: 2 leituras do indice + %lu comparacoes\n", (unsigned long)passos_pior_caso(t->maior_balde));
+
+    printf("busca autorizada: %6.1f ns\n", medir(CREDENCIAIS_TESTE_IDS, n, repeticoes));
+    printf("busca ausente:    %6.1f ns\n", medir(CREDENCIAIS_TESTE_AUSENTES, n, repeticoes));
+
+    // Entrada seguida de saída: uma busca, depois bitmap e ocupação sob o
+    // spinlock duas vezes
+    static ocupacao_t ocupacao;
+    static credencial_t credencial;
+    ocupacao_iniciar(&ocupacao, 1);
+    credencial_iniciar(&credencial, t, credenciais_presentes, &ocupacao);
+    uint16_t usuarios;
+    uint64_t inicio = agora_ns();
+    for (uint32_t i = 0; i < n; i++)
+    {
+        int32_t k = credencial_buscar(t, CREDENCIAIS_TESTE_IDS[i]);
+        if (credencial_entrar(&credencial, k, &usuarios) != CREDENCIAL_ACEITA ||
+            credencial_sair(&credencial, k, &usuarios) != CREDENCIAL_ACEITA)
+        {
+            falhas++;
+        }
+    }
+    printf("entrada + saida:  %6.1f ns\n", (double)(agora_ns() - inicio) / n);
+
+    if (credencial_sair(&credencial, credencial_buscar(t, CREDENCIAIS_TESTE_IDS[0]), &usuarios) !=
+            CREDENCIAL_PRESENCA ||
+        credencial_entrar(&credencial, credencial_buscar(t, CREDENCIAIS_TESTE_AUSENTES[0]), &usuarios) !=
+            CREDENCIAL_DESCONHECIDA)
+    {
+        falhas++;
+    }
+
+    printf("%s\n", falhas ? "FALHOU" : "ok");
+    return falhas ? 1 : 0;
+}
@@ -0,0 +1,17 @@
+/*
+ * Benchmark de renderização no PC: roda os casos de bench/bench_render.c
+ * uma vez, sem escalonador, e sai com erro se algum quadro de referência
+ * divergir.
+ */
+
+#include "bench/bench_render.h"
+#include "pico/stdlib.h"
+
+void npInit(uint pin);
+
+int main(void)
+{
+    stdio_init_all();
+    npInit(7); // Matriz WS2812B (pino da BitDogLab; no PC só aloca o DMA)
+    return bench_render_executar() ? 1 : 0;
+}
@@ -0,0 +1,86 @@
+#include "flash_arquivo.h"
+#include <stdio.h>
+#include <string.h>
+
+static bool ler_bruto(FILE *f, uint32_t offset, void *destino, uint32_t n)
+{
+    return fseek(f, offset, SEEK_SET) == 0 && fread(destino, 1, n, f) == n;
+}
+
+static bool gravar_bruto(FILE *f, uint32_t offset, const void *origem, uint32_t n)
+{
+    return fseek(f, offset, SEEK_SET) == 0 && fwrite(origem, 1, n, f) == n && fflush(f) == 0;
+}
+
+static bool arquivo_ler(const flash_ops_t *ops, uint32_t offset, void *destino, uint32_t n)
+{
+    return flash_ops_valido(ops, offset, n, 1) && ler_bruto(ops->ctx, offset, destino, n);
+}
+
+static bool arquivo_apagar(const flash_ops_t *ops, uint32_t offset)
+{
+    uint8_t setor[FLASH_OPS_SETOR];
+    if (!flash_ops_valido(ops, offset, FLASH_OPS_SETOR, FLASH_OPS_SETOR))
+    {
+        return false;
+    }
+    memset(setor, 0xFF, sizeof(setor));
+    return gravar_bruto(ops->ctx, offset, setor, sizeof(setor));
+}
+
+// Como na NOR, gravar só zera bits: o resultado é o E com o conteúdo atual
+static bool arquivo_programar(const flash_ops_t *ops, uint32_t offset, const void *origem)
+{
+    const uint8_t *p = origem;
+    uint8_t pagina[FLASH_OPS_PAGINA];
+    if (!flash_ops_valido(ops, offset, FLASH_OPS_PAGINA, FLASH_OPS_PAGINA) ||
+        !ler_bruto(ops->ctx, offset, pagina, sizeof(pagina)))
+    {
+        return false;
+    }
+    for (int i = 0; i < FLASH_OPS_PAGINA; i++)
+    {
+        pagina[i] &= p[i];
+    }
+    return gravar_bruto(ops->ctx, offset, pagina, sizeof(pagina));
+}
+
+bool flash_ops_arquivo(flash_ops_t *ops, const char *caminho, uint32_t tamanho)
+{
+    FILE *f = fopen(caminho, "r+b");
+    if (f == NULL)
+    {
+        // Arquivo novo: começa com a região toda apagada
+        uint8_t setor[FLASH_OPS_SETOR];
+        memset(setor, 0xFF, sizeof(setor));
+        f = fopen(caminho, "w+b");
+        for (uint32_t off = 0; f && off < tamanho; off += FLASH_OPS_SETOR)
+        {
+            if (!gravar_bruto(f, off, setor, sizeof(setor)))
+            {
+                fclose(f);
+                f = NULL;
+            }
+        }
+        if (f == NULL)
+        {
+            return false;
+        }
+    }
+
+    ops->ler = arquivo_ler;
+    ops->apagar = arquivo_apagar;
+    ops->programar = arquivo_programar;
+    ops->ctx = f;
+    ops->tamanho = tamanho;
+    return true;
+}
+
+void flash_ops_arquivo_fechar(flash_ops_t *ops)
+{
+    if (ops->ctx)
+    {
+        fclose(ops->ctx);
+        ops->ctx = NULL;
+    }
+}
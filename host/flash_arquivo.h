@@ -0,0 +1,15 @@
+#ifndef FLASH_ARQUIVO_H
+#define FLASH_ARQUIVO_H
+
+#include "flash_ops.h"
+
+// Backend de flash_ops_t para o PC: a região é um arquivo que imita uma
+// flash NOR (apagar grava 0xFF no setor, programar faz E bit a bit com o
+// conteúdo atual). Se o arquivo não existir é criado já apagado.
+// Retorna false se o arquivo não puder ser aberto ou criado.
+bool flash_ops_arquivo(flash_ops_t *ops, const char *caminho, uint32_t tamanho);
+
+// Fecha o arquivo aberto por flash_ops_arquivo
+void flash_ops_arquivo_fechar(flash_ops_t *ops);
+
+#endif /* FLASH_ARQUIVO_H */
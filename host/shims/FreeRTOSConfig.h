@@ -0,0 +1,93 @@
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/* Configuração do FreeRTOS para a simulação no PC (port GCC_POSIX). Segue
+ * lib/FreeRTOSConfig.h no que a aplicação enxerga (tick de 1 ms, 32
+ * prioridades, heap_4, filas e semáforos); muda só o que o port POSIX
+ * exige. Cada tarefa é uma pthread cuja pilha vem do heap do FreeRTOS,
+ * então a pilha mínima precisa comportar a libc. */
+
+/* Scheduler Related */
+#define configUSE_PREEMPTION                    1
+#define configUSE_TICKLESS_IDLE                 0
+#define configUSE_IDLE_HOOK                     0
+#define configUSE_TICK_HOOK                     0
+#define configTICK_RATE_HZ                      ( ( TickType_t ) 1000 )
+#define configMAX_PRIORITIES                    32
+#define configMINIMAL_STACK_SIZE                ( configSTACK_DEPTH_TYPE ) 4096
+#define configUSE_16_BIT_TICKS                  0
+#define configIDLE_SHOULD_YIELD                 1
+
+/* Synchronization Related */
+#define configUSE_MUTEXES                       1
+#define configUSE_RECURSIVE_MUTEXES             1
+#define configUSE_COUNTING_SEMAPHORES           1
+#define configQUEUE_REGISTRY_SIZE               8
+#define configUSE_QUEUE_SETS                    1
+#define configUSE_TIME_SLICING                  1
+#define configUSE_NEWLIB_REENTRANT              0
+#define configENABLE_BACKWARD_COMPATIBILITY     0
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS 5
+
+/* System */
+#define configSTACK_DEPTH_TYPE                  uint32_t
+#define configMESSAGE_BUFFER_LENGTH_TYPE        size_t
+
+/* Memory allocation related definitions. */
+#define configSUPPORT_STATIC_ALLOCATION         0
+#define configSUPPORT_DYNAMIC_ALLOCATION        1
+#define configTOTAL_HEAP_SIZE                   ( 2 * 1024 * 1024 )
+#define configAPPLICATION_ALLOCATED_HEAP        0
+
+/* Hook function related definitions. */
+#define configCHECK_FOR_STACK_OVERFLOW          0 /* Sem sentido com pilhas de pthread */
+#define configUSE_MALLOC_FAILED_HOOK            0
+#define configUSE_DAEMON_TASK_STARTUP_HOOK      0
+
+/* Run time and task stats gathering related definitions. */
+#ifdef PERFIL
+#define configGENERATE_RUN_TIME_STATS           1
+extern uint32_t perfil_contador_us(void);
+extern void perfil_fila_nivel(void *fila, uint32_t nivel);
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()        perfil_contador_us()
+/* Pico das filas: cada envio informa a ocupação logo após a cópia (a
+ * sobrescrita de uma fila cheia não passa do tamanho). Expande em queue.c,
+ * dentro da seção crítica da fila. */
+#define PERFIL_NIVEL_APOS_ENVIO(q) \
+    ((q)->uxMessagesWaiting < (q)->uxLength ? (q)->uxMessagesWaiting + 1 : (q)->uxLength)
+#define traceQUEUE_SEND(pxQueue)                perfil_fila_nivel((pxQueue), PERFIL_NIVEL_APOS_ENVIO(pxQueue))
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)       perfil_fila_nivel((pxQueue), PERFIL_NIVEL_APOS_ENVIO(pxQueue))
+#else
+#define configGENERATE_RUN_TIME_STATS           0
+#endif
+#define configUSE_TRACE_FACILITY                1
+#define configUSE_STATS_FORMATTING_FUNCTIONS    0
+
+/* Co-routine related definitions. */
+#define configUSE_CO_ROUTINES                   0
+#define configMAX_CO_ROUTINE_PRIORITIES         1
+
+/* Software timer related definitions (a aplicação não usa timers). */
+#define configUSE_TIMERS                        0
+
+#include <assert.h>
+#define configASSERT(x)                         assert(x)
+
+#define INCLUDE_vTaskPrioritySet                1
+#define INCLUDE_uxTaskPriorityGet               1
+#define INCLUDE_vTaskDelete                     1
+#define INCLUDE_vTaskSuspend                    1
+#define INCLUDE_vTaskDelayUntil                 1
+#define INCLUDE_vTaskDelay                      1
+#define INCLUDE_xTaskGetSchedulerState          1
+#define INCLUDE_xTaskGetCurrentTaskHandle       1
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
+#define INCLUDE_xTaskGetIdleTaskHandle          1
+#define INCLUDE_eTaskGetState                   1
+#define INCLUDE_xTaskAbortDelay                 1
+#define INCLUDE_xTaskGetHandle                  1
+#define INCLUDE_xTaskResumeFromISR              1
+#define INCLUDE_xQueueGetMutexHolder            1
+
+#endif /* FREERTOS_CONFIG_H */
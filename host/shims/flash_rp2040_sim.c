@@ -0,0 +1,20 @@
+#include "flash_ops.h"
+#include "flash_arquivo.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+
+// O arquivo não desliga interrupções
+volatile uint32_t flash_ops_bloqueio_us;
+
+// Cada região da flash vira um arquivo no diretório atual, nomeado pelo
+// offset (ex.: flash_1f0000.bin para o diário), e sobrevive entre execuções
+// como a flash sobrevive a um reset.
+void flash_ops_rp2040(flash_ops_t *ops, uint32_t offset, uint32_t tamanho)
+{
+    char caminho[32];
+    snprintf(caminho, sizeof(caminho), "flash_%06lx.bin", (unsigned long)offset);
+    if (!flash_ops_arquivo(ops, caminho, tamanho))
+    {
+        panic("Nao foi possivel abrir %s", caminho);
+    }
+}
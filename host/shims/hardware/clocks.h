@@ -0,0 +1,14 @@
+#ifndef SIM_HARDWARE_CLOCKS_H
+#define SIM_HARDWARE_CLOCKS_H
+
+#include "pico/stdlib.h"
+
+enum clock_index
+{
+    clk_sys = 5,
+};
+
+// Frequência nominal do RP2040 (125 MHz)
+uint32_t clock_get_hz(enum clock_index clk);
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef SIM_HARDWARE_DMA_H
+#define SIM_HARDWARE_DMA_H
+
+#include "pico/stdlib.h"
+
+// DMA simulado: a transferência não copia nada (não há periférico do outro
+// lado); ela só termina depois do tempo que o DREQ levaria para consumir as
+// palavras e então levanta o IRQ do canal, se habilitado.
+enum dma_channel_transfer_size
+{
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2,
+};
+
+typedef struct
+{
+    uint dreq;
+} dma_channel_config;
+
+int dma_claim_unused_channel(bool obrigatorio);
+dma_channel_config dma_channel_get_default_config(uint canal);
+static inline void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size t)
+{
+    (void)c;
+    (void)t;
+}
+static inline void channel_config_set_read_increment(dma_channel_config *c, bool inc)
+{
+    (void)c;
+    (void)inc;
+}
+static inline void channel_config_set_write_increment(dma_channel_config *c, bool inc)
+{
+    (void)c;
+    (void)inc;
+}
+static inline void channel_config_set_dreq(dma_channel_config *c, uint dreq)
+{
+    c->dreq = dreq;
+}
+void dma_channel_configure(uint canal, const dma_channel_config *c, volatile void *destino,
+                           const volatile void *origem, uint n, bool iniciar);
+void dma_channel_transfer_from_buffer_now(uint canal, const volatile void *origem, uint n);
+void dma_channel_abort(uint canal);
+void dma_channel_set_irq1_enabled(uint canal, bool enabled);
+bool dma_channel_get_irq1_status(uint canal);
+void dma_channel_acknowledge_irq1(uint canal);
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef SIM_HARDWARE_GPIO_H
+#define SIM_HARDWARE_GPIO_H
+
+#include "pico/stdlib.h" // GPIO declarado junto com o resto do pico_stdlib
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef SIM_HARDWARE_I2C_H
+#define SIM_HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+// Registradores que o envio assíncrono do ssd1306 toca. O barramento está
+// sempre ocioso: a duração de um envio é simulada pelo DMA.
+typedef struct
+{
+    volatile uint32_t enable, tar, data_cmd, status, clr_tx_abrt;
+} i2c_hw_t;
+
+typedef struct
+{
+    i2c_hw_t *hw;
+    uint dreq;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst, i2c1_inst;
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+#define I2C_IC_DATA_CMD_STOP_BITS 0x200u
+#define I2C_IC_DATA_CMD_RESTART_BITS 0x400u
+#define I2C_IC_STATUS_ACTIVITY_BITS 0x1u
+#define I2C_IC_STATUS_TFE_BITS 0x4u
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t endereco, const uint8_t *dados, size_t n, bool nostop);
+static inline i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c)
+{
+    return i2c->hw;
+}
+static inline uint i2c_get_dreq(i2c_inst_t *i2c, bool tx)
+{
+    (void)tx;
+    return i2c->dreq;
+}
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef SIM_HARDWARE_PIO_H
+#define SIM_HARDWARE_PIO_H
+
+#include "pico/stdlib.h"
+
+typedef struct
+{
+    volatile uint32_t txf[4];
+} pio_hw_t;
+typedef pio_hw_t *PIO;
+
+extern pio_hw_t pio0_hw, pio1_hw;
+#define pio0 (&pio0_hw)
+#define pio1 (&pio1_hw)
+
+typedef struct
+{
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;
+} pio_program_t;
+
+uint pio_add_program(PIO pio, const pio_program_t *programa);
+int pio_claim_unused_sm(PIO pio, bool obrigatorio);
+uint pio_get_dreq(PIO pio, uint sm, bool tx);
+
+#endif
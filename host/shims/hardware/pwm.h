@@ -0,0 +1,20 @@
+#ifndef SIM_HARDWARE_PWM_H
+#define SIM_HARDWARE_PWM_H
+
+#include "pico/stdlib.h"
+
+// O buzzer não faz som no PC: o PWM só guarda a configuração
+typedef struct
+{
+    uint32_t csr, div, top;
+} pwm_config;
+
+uint pwm_gpio_to_slice_num(uint gpio);
+pwm_config pwm_get_default_config(void);
+void pwm_init(uint slice, pwm_config *c, bool iniciar);
+void pwm_set_clkdiv_int_frac(uint slice, uint8_t inteiro, uint8_t fracao);
+void pwm_set_wrap(uint slice, uint16_t wrap);
+void pwm_set_gpio_level(uint gpio, uint16_t nivel);
+void pwm_set_enabled(uint slice, bool enabled);
+
+#endif
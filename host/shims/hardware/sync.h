@@ -0,0 +1,18 @@
+#ifndef SIM_HARDWARE_SYNC_H
+#define SIM_HARDWARE_SYNC_H
+
+#include "pico/stdlib.h"
+
+// "Desligar interrupções" vira uma seção crítica do FreeRTOS: no port POSIX
+// ela bloqueia o tick, então nem as tarefas nem o contexto de interrupção
+// simulado (que é uma tarefa) podem entrar no meio.
+typedef volatile uint32_t spin_lock_t;
+
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t estado);
+int spin_lock_claim_unused(bool obrigatorio);
+spin_lock_t *spin_lock_init(uint num);
+uint32_t spin_lock_blocking(spin_lock_t *lock);
+void spin_unlock(spin_lock_t *lock, uint32_t estado);
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef SIM_PICO_STDLIB_H
+#define SIM_PICO_STDLIB_H
+
+// Substituto do pico/stdlib.h para a simulação no PC (host/). Só declara o
+// que a aplicação usa; a implementação está em host/shims/pico_sim.c. O
+// tempo é o relógio monotônico do PC contado a partir do início do processo.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+#define PICO_ON_DEVICE 0 // Como num build "host" do SDK
+
+#define __uninitialized_ram(v) v
+#define __not_in_flash_func(f) f
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+#define PICO_FLASH_SIZE_BYTES (2u * 1024 * 1024)
+#define PICO_ERROR_TIMEOUT (-1)
+
+// Tempo
+typedef uint64_t absolute_time_t;
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+absolute_time_t get_absolute_time(void);
+static inline int64_t absolute_time_diff_us(absolute_time_t de, absolute_time_t ate)
+{
+    return (int64_t)(ate - de);
+}
+static inline uint64_t to_us_since_boot(absolute_time_t t)
+{
+    return t;
+}
+static inline uint32_t to_ms_since_boot(absolute_time_t t)
+{
+    return (uint32_t)(t / 1000);
+}
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+static inline void tight_loop_contents(void)
+{
+}
+
+// Alarmes: disparam no contexto de interrupção simulado (sim_interrupcoes)
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past);
+
+// GPIO: saídas guardam o nível; as interrupções vêm do injetor de eventos
+#define GPIO_IN false
+#define GPIO_OUT true
+#define GPIO_IRQ_EDGE_FALL 0x4u
+#define GPIO_IRQ_EDGE_RISE 0x8u
+enum gpio_function
+{
+    GPIO_FUNC_I2C = 3,
+    GPIO_FUNC_PWM = 4,
+    GPIO_FUNC_SIO = 5,
+};
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t events);
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool saida);
+void gpio_pull_up(uint gpio);
+void gpio_put(uint gpio, bool valor);
+bool gpio_get_out_level(uint gpio);
+void gpio_set_function(uint gpio, enum gpio_function fn);
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled);
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback);
+
+// Console: a saída vai para o stdout; não há entrada
+bool stdio_init_all(void);
+int getchar_timeout_us(uint32_t timeout_us);
+void stdio_set_chars_available_callback(void (*fn)(void *), void *param);
+
+void panic(const char *fmt, ...);
+void panic_unsupported(void);
+
+#endif /* SIM_PICO_STDLIB_H */
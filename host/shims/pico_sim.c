@@ -0,0 +1,558 @@
+#include "pico_sim.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/i2c.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "hardware/pwm.h"
+#include "hardware/sync.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// ---------------------------------------------------------------------------
+// Tempo
+// ---------------------------------------------------------------------------
+
+static uint64_t relogio_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static uint64_t boot_us;
+
+// O "boot" é o início do processo, como no RP2040
+__attribute__((constructor)) static void sim_boot(void)
+{
+    boot_us = relogio_us();
+}
+
+uint64_t time_us_64(void)
+{
+    return relogio_us() - boot_us;
+}
+
+uint32_t time_us_32(void)
+{
+    return (uint32_t)time_us_64();
+}
+
+absolute_time_t get_absolute_time(void)
+{
+    return time_us_64();
+}
+
+// Espera ocupada: dormir no sistema bloquearia a thread da tarefa sem o
+// escalonador saber
+void sleep_us(uint64_t us)
+{
+    uint64_t fim = time_us_64() + us;
+    while (time_us_64() < fim)
+    {
+    }
+}
+
+void sleep_ms(uint32_t ms)
+{
+    sleep_us((uint64_t)ms * 1000);
+}
+
+// ---------------------------------------------------------------------------
+// Seções críticas e spinlocks
+// ---------------------------------------------------------------------------
+
+uint32_t save_and_disable_interrupts(void)
+{
+    if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED)
+    {
+        return 0; // Ainda só há a thread do main
+    }
+    taskENTER_CRITICAL();
+    return 1;
+}
+
+void restore_interrupts(uint32_t estado)
+{
+    if (estado)
+    {
+        taskEXIT_CRITICAL();
+    }
+}
+
+#define SIM_SPINLOCKS 32
+static spin_lock_t spinlocks[SIM_SPINLOCKS];
+static int spinlocks_usados;
+
+int spin_lock_claim_unused(bool obrigatorio)
+{
+    if (spinlocks_usados == SIM_SPINLOCKS)
+    {
+        if (obrigatorio)
+        {
+            panic("Sem spinlocks livres");
+        }
+        return -1;
+    }
+    return spinlocks_usados++;
+}
+
+spin_lock_t *spin_lock_init(uint num)
+{
+    spinlocks[num] = 0;
+    return &spinlocks[num];
+}
+
+uint32_t spin_lock_blocking(spin_lock_t *lock)
+{
+    uint32_t estado = save_and_disable_interrupts();
+    *lock = 1;
+    return estado;
+}
+
+void spin_unlock(spin_lock_t *lock, uint32_t estado)
+{
+    *lock = 0;
+    restore_interrupts(estado);
+}
+
+// ---------------------------------------------------------------------------
+// Alarmes
+// ---------------------------------------------------------------------------
+
+#define SIM_ALARMES 16
+
+typedef struct
+{
+    bool ativo;
+    uint64_t alvo_us;
+    alarm_callback_t callback;
+    void *dados;
+} sim_alarme_t;
+
+static sim_alarme_t alarmes[SIM_ALARMES];
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+    (void)fire_if_past; // Alarmes vencidos sempre disparam na próxima passada
+    alarm_id_t id = -1;
+    uint32_t estado = save_and_disable_interrupts();
+    for (int i = 0; i < SIM_ALARMES; i++)
+    {
+        if (!alarmes[i].ativo)
+        {
+            alarmes[i] = (sim_alarme_t){true, time_us_64() + us, callback, user_data};
+            id = i + 1;
+            break;
+        }
+    }
+    restore_interrupts(estado);
+    return id;
+}
+
+// Mesma regra de reagendamento do SDK: retorno negativo conta a partir do
+// alvo anterior, positivo a partir de agora (fim do callback), zero encerra
+static void sim_alarmes(void)
+{
+    for (int i = 0; i < SIM_ALARMES; i++)
+    {
+        sim_alarme_t *a = &alarmes[i];
+        if (!a->ativo || a->alvo_us > time_us_64())
+        {
+            continue;
+        }
+        int64_t r = a->callback(i + 1, a->dados);
+        if (r < 0)
+        {
+            a->alvo_us += (uint64_t)-r;
+        }
+        else if (r > 0)
+        {
+            a->alvo_us = time_us_64() + (uint64_t)r;
+        }
+        else
+        {
+            a->ativo = false;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// DMA e IRQs
+// ---------------------------------------------------------------------------
+
+#define SIM_CANAIS 12
+#define SIM_DREQ_PIO1 8
+#define SIM_DREQ_I2C0 32
+#define SIM_DREQ_I2C1 34
+
+typedef struct
+{
+    uint dreq;
+    bool ocupado;
+    uint64_t fim_us;
+    bool irq1_habilitado;
+    bool irq1_status;
+} sim_canal_t;
+
+static sim_canal_t canais[SIM_CANAIS];
+static int canais_usados;
+
+#define SIM_HANDLERS 4
+static irq_handler_t handlers_dma1[SIM_HANDLERS];
+static bool dma1_habilitado;
+
+int dma_claim_unused_channel(bool obrigatorio)
+{
+    if (canais_usados == SIM_CANAIS)
+    {
+        if (obrigatorio)
+        {
+            panic("Sem canais de DMA livres");
+        }
+        return -1;
+    }
+    return canais_usados++;
+}
+
+dma_channel_config dma_channel_get_default_config(uint canal)
+{
+    (void)canal;
+    return (dma_channel_config){0};
+}
+
+void dma_channel_configure(uint canal, const dma_channel_config *c, volatile void *destino,
+                           const volatile void *origem, uint n, bool iniciar)
+{
+    (void)destino;
+    canais[canal].dreq = c->dreq;
+    if (iniciar)
+    {
+        dma_channel_transfer_from_buffer_now(canal, origem, n);
+    }
+}
+
+// Duração de 'n' palavras no ritmo do DREQ: I2C a 400 kHz (9 bits por byte)
+// ou WS2812 a 800 kHz (24 bits por LED)
+static uint64_t duracao_us(uint dreq, uint n)
+{
+    if (dreq == SIM_DREQ_I2C0 || dreq == SIM_DREQ_I2C1)
+    {
+        return (uint64_t)n * 45 / 2;
+    }
+    return (uint64_t)n * 30;
+}
+
+#define SIM_PIO_PALAVRAS 2048
+static uint32_t pio_quadro[SIM_PIO_PALAVRAS];
+static uint pio_palavras;
+
+const uint32_t *sim_pio_ultimo_quadro(uint *n)
+{
+    *n = pio_palavras;
+    return pio_palavras ? pio_quadro : NULL;
+}
+
+void dma_channel_transfer_from_buffer_now(uint canal, const volatile void *origem, uint n)
+{
+    uint32_t estado = save_and_disable_interrupts();
+    if (canais[canal].dreq < SIM_DREQ_I2C0) // FIFO TX de uma máquina PIO
+    {
+        pio_palavras = n < SIM_PIO_PALAVRAS ? n : SIM_PIO_PALAVRAS;
+        for (uint i = 0; i < pio_palavras; i++)
+        {
+            pio_quadro[i] = ((const volatile uint32_t *)origem)[i];
+        }
+    }
+    canais[canal].fim_us = time_us_64() + duracao_us(canais[canal].dreq, n);
+    canais[canal].ocupado = true;
+    restore_interrupts(estado);
+}
+
+void dma_channel_abort(uint canal)
+{
+    uint32_t estado = save_and_disable_interrupts();
+    canais[canal].ocupado = false;
+    canais[canal].irq1_status = false;
+    restore_interrupts(estado);
+}
+
+void dma_channel_set_irq1_enabled(uint canal, bool enabled)
+{
+    canais[canal].irq1_habilitado = enabled;
+}
+
+bool dma_channel_get_irq1_status(uint canal)
+{
+    return canais[canal].irq1_status;
+}
+
+void dma_channel_acknowledge_irq1(uint canal)
+{
+    canais[canal].irq1_status = false;
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t prioridade)
+{
+    (void)prioridade;
+    if (num != DMA_IRQ_1)
+    {
+        panic("IRQ %u nao simulado", num);
+    }
+    for (int i = 0; i < SIM_HANDLERS; i++)
+    {
+        if (handlers_dma1[i] == NULL)
+        {
+            handlers_dma1[i] = handler;
+            return;
+        }
+    }
+    panic("Handlers demais no DMA_IRQ_1");
+}
+
+void irq_set_enabled(uint num, bool enabled)
+{
+    if (num == DMA_IRQ_1)
+    {
+        dma1_habilitado = enabled;
+    }
+}
+
+static void sim_dma(void)
+{
+    bool pendente = false;
+    for (int i = 0; i < canais_usados; i++)
+    {
+        sim_canal_t *c = &canais[i];
+        if (c->ocupado && c->fim_us <= time_us_64())
+        {
+            c->ocupado = false;
+            c->irq1_status = c->irq1_habilitado;
+        }
+        pendente |= c->irq1_status;
+    }
+    for (int i = 0; pendente && dma1_habilitado && i < SIM_HANDLERS && handlers_dma1[i]; i++)
+    {
+        handlers_dma1[i]();
+    }
+}
+
+void sim_interrupcoes(void)
+{
+    sim_alarmes();
+    sim_dma();
+}
+
+// ---------------------------------------------------------------------------
+// GPIO
+// ---------------------------------------------------------------------------
+
+#define SIM_PINOS 30
+
+static bool niveis[SIM_PINOS];
+static uint32_t irq_eventos[SIM_PINOS];
+static gpio_irq_callback_t gpio_callback;
+
+void gpio_init(uint gpio)
+{
+    niveis[gpio] = false;
+}
+
+void gpio_set_dir(uint gpio, bool saida)
+{
+    (void)gpio;
+    (void)saida;
+}
+
+void gpio_pull_up(uint gpio)
+{
+    niveis[gpio] = true;
+}
+
+void gpio_put(uint gpio, bool valor)
+{
+    niveis[gpio] = valor;
+}
+
+bool gpio_get_out_level(uint gpio)
+{
+    return niveis[gpio];
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn)
+{
+    (void)gpio;
+    (void)fn;
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled)
+{
+    if (enabled)
+    {
+        irq_eventos[gpio] |= events;
+    }
+    else
+    {
+        irq_eventos[gpio] &= ~events;
+    }
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback)
+{
+    gpio_callback = callback;
+    gpio_set_irq_enabled(gpio, events, enabled);
+}
+
+void sim_gpio_borda(uint gpio, uint32_t eventos)
+{
+    niveis[gpio] = !(eventos & GPIO_IRQ_EDGE_FALL);
+    if (gpio_callback && (irq_eventos[gpio] & eventos))
+    {
+        gpio_callback(gpio, irq_eventos[gpio] & eventos);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// I2C, PIO, PWM e relógios: só o estado que a aplicação lê de volta
+// ---------------------------------------------------------------------------
+
+static i2c_hw_t i2c0_hw = {.status = I2C_IC_STATUS_TFE_BITS};
+static i2c_hw_t i2c1_hw = {.status = I2C_IC_STATUS_TFE_BITS};
+i2c_inst_t i2c0_inst = {&i2c0_hw, SIM_DREQ_I2C0};
+i2c_inst_t i2c1_inst = {&i2c1_hw, SIM_DREQ_I2C1};
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate)
+{
+    (void)i2c;
+    return baudrate;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t endereco, const uint8_t *dados, size_t n, bool nostop)
+{
+    (void)i2c;
+    (void)endereco;
+    (void)dados;
+    (void)nostop;
+    return (int)n;
+}
+
+pio_hw_t pio0_hw, pio1_hw;
+static int pio_sms_usadas[2];
+
+uint pio_add_program(PIO pio, const pio_program_t *programa)
+{
+    (void)pio;
+    (void)programa;
+    return 0;
+}
+
+int pio_claim_unused_sm(PIO pio, bool obrigatorio)
+{
+    int *usadas = &pio_sms_usadas[pio == pio1];
+    if (*usadas == 4)
+    {
+        if (obrigatorio)
+        {
+            panic("Sem maquinas PIO livres");
+        }
+        return -1;
+    }
+    return (*usadas)++;
+}
+
+uint pio_get_dreq(PIO pio, uint sm, bool tx)
+{
+    (void)tx;
+    return (pio == pio1 ? SIM_DREQ_PIO1 : 0) + sm;
+}
+
+uint pwm_gpio_to_slice_num(uint gpio)
+{
+    return (gpio >> 1) & 7;
+}
+
+pwm_config pwm_get_default_config(void)
+{
+    return (pwm_config){0};
+}
+
+void pwm_init(uint slice, pwm_config *c, bool iniciar)
+{
+    (void)slice;
+    (void)c;
+    (void)iniciar;
+}
+
+void pwm_set_clkdiv_int_frac(uint slice, uint8_t inteiro, uint8_t fracao)
+{
+    (void)slice;
+    (void)inteiro;
+    (void)fracao;
+}
+
+void pwm_set_wrap(uint slice, uint16_t wrap)
+{
+    (void)slice;
+    (void)wrap;
+}
+
+void pwm_set_gpio_level(uint gpio, uint16_t nivel)
+{
+    (void)gpio;
+    (void)nivel;
+}
+
+void pwm_set_enabled(uint slice, bool enabled)
+{
+    (void)slice;
+    (void)enabled;
+}
+
+uint32_t clock_get_hz(enum clock_index clk)
+{
+    (void)clk;
+    return 125000000;
+}
+
+// ---------------------------------------------------------------------------
+// Console e pânico
+// ---------------------------------------------------------------------------
+
+bool stdio_init_all(void)
+{
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    return true;
+}
+
+int getchar_timeout_us(uint32_t timeout_us)
+{
+    (void)timeout_us;
+    return PICO_ERROR_TIMEOUT; // O console da simulação é só de saída
+}
+
+void stdio_set_chars_available_callback(void (*fn)(void *), void *param)
+{
+    // Sem entrada, o aviso nunca é chamado
+    (void)fn;
+    (void)param;
+}
+
+void panic(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    fputs("*** PANIC ***\n", stderr);
+    vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+    abort();
+}
+
+void panic_unsupported(void)
+{
+    panic("nao suportado");
+}
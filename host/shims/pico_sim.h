@@ -0,0 +1,24 @@
+#ifndef PICO_SIM_H
+#define PICO_SIM_H
+
+#include "pico/stdlib.h"
+
+// Lado do "hardware" da simulação, usado pelo injetor (host/simulador.c).
+//
+// Não há interrupções de verdade no port POSIX do FreeRTOS: o contexto de
+// interrupção é uma tarefa na prioridade máxima, que nunca é preemptada
+// pelas tarefas da aplicação. É ela que chama as duas funções abaixo.
+
+// Roda os alarmes vencidos e os IRQs de DMA das transferências concluídas
+void sim_interrupcoes(void);
+
+// Borda num pino de entrada: chama o callback de GPIO se a interrupção
+// estiver habilitada para esse pino e evento
+void sim_gpio_borda(uint gpio, uint32_t eventos);
+
+// Último quadro entregue por DMA a uma FIFO da PIO (cópia feita no início
+// da transferência); NULL se não houve nenhum. Permite conferir o que a
+// matriz de LEDs receberia.
+const uint32_t *sim_pio_ultimo_quadro(uint *n);
+
+#endif /* PICO_SIM_H */
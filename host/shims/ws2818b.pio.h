@@ -0,0 +1,20 @@
+#ifndef SIM_WS2818B_PIO_H
+#define SIM_WS2818B_PIO_H
+
+// Substituto do cabeçalho gerado a partir de lib/ws2818b.pio: no PC não há
+// máquina PIO, o quadro só ocupa o DMA pelo tempo da transmissão a 800 kHz.
+
+#include "hardware/pio.h"
+
+static const pio_program_t ws2818b_program = {NULL, 4, -1};
+
+static inline void ws2818b_program_init(PIO pio, uint sm, uint offset, uint pin, float freq)
+{
+    (void)pio;
+    (void)sm;
+    (void)offset;
+    (void)pin;
+    (void)freq;
+}
+
+#endif
@@ -0,0 +1,196 @@
+/*
+ * Simulação de carga do controle de acesso no PC.
+ *
+ * LibraryAccessControl.c é compilado sem mudanças (main vira app_main)
+ * sobre o port POSIX do FreeRTOS e os substitutos de HAL em host/shims. Um
+ * injetor, no contexto de interrupção simulado, dispara bordas nos botões
+ * A, B e no joystick num ritmo fixo e, ao final, imprime vazão, eventos
+ * descartados e a latência de cada etapa (histogramas de lib/rastreio.c).
+ *
+ * Uso: simulador [-n eventos] [-t eventos/s] [-r 1 reset a cada N] [-s semente]
+ */
+
+#include "pico/stdlib.h"
+#include "pico_sim.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "ocupacao.h"
+#include "diario.h"
+#include "rastreio.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#ifndef RASTREIO
+#error "A simulação mede a latência com o rastreio: compile com RASTREIO"
+#endif
+
+/* Pinos e debounce de LibraryAccessControl.c */
+#define BOTAO_A 5
+#define BOTAO_B 6
+#define JOYSTICK 22
+#define DEBOUNCE_MS 200
+
+int app_main();
+
+/* Estado da aplicação lido (ou, no caso do debounce, reescrito) pelo injetor */
+extern absolute_time_t ultimoA, ultimoB, ultimoJoystick;
+extern volatile uint32_t eventosDescartados;
+extern ocupacao_t ocupacao;
+extern diario_anel_t anelDiario;
+
+typedef struct
+{
+    uint32_t eventos;     // Total a injetar
+    uint32_t taxa;        // Eventos por segundo
+    uint32_t reset_cada;  // Em média um reset a cada N eventos (0: nenhum)
+    unsigned semente;     // Sorteio entre A e B
+    uint32_t drenagem_ms; // Espera final para as filas esvaziarem
+} sim_config_t;
+
+static sim_config_t cfg = {10000, 2000, 50, 1, 500};
+
+typedef enum
+{
+    SIM_ENTRADA,
+    SIM_SAIDA,
+    SIM_RESET,
+    SIM_TIPOS
+} sim_tipo_t;
+
+static const char *const NOMES[SIM_TIPOS] = {"entrada (A)", "saida (B)", "reset"};
+static const uint PINOS[SIM_TIPOS] = {BOTAO_A, BOTAO_B, JOYSTICK};
+
+static uint32_t injetados[SIM_TIPOS];
+static uint64_t isr_total_us;
+static uint32_t isr_max_us;
+
+static sim_tipo_t sortear(void)
+{
+    uint32_t r = (uint32_t)rand_r(&cfg.semente);
+    if (cfg.reset_cada && r % cfg.reset_cada == 0)
+    {
+        return SIM_RESET;
+    }
+    return (r >> 16) & 1 ? SIM_ENTRADA : SIM_SAIDA;
+}
+
+// Uma pressão já sem trepidação: o injetor zera o instante da última borda
+// aceita, então o debounce de 200 ms não limita a taxa
+static void injetar(sim_tipo_t tipo)
+{
+    absolute_time_t *ultimo[SIM_TIPOS] = {&ultimoA, &ultimoB, &ultimoJoystick};
+    *ultimo[tipo] = 0;
+
+    uint32_t inicio = time_us_32();
+    sim_gpio_borda(PINOS[tipo], GPIO_IRQ_EDGE_FALL);
+    uint32_t dt = time_us_32() - inicio;
+
+    isr_total_us += dt;
+    if (dt > isr_max_us)
+    {
+        isr_max_us = dt;
+    }
+    injetados[tipo]++;
+}
+
+static uint32_t processados(void)
+{
+    uint32_t n = 0;
+    for (int b = 0; b < RASTREIO_BALDES; b++)
+    {
+        n += rastreio_hist[RASTREIO_FILA][b];
+    }
+    return n;
+}
+
+static void relatorio(uint64_t duracao_us)
+{
+    uint32_t total = injetados[SIM_ENTRADA] + injetados[SIM_SAIDA] + injetados[SIM_RESET];
+    uint32_t botoes = injetados[SIM_ENTRADA] + injetados[SIM_SAIDA];
+    uint32_t feitos = processados();
+    uint32_t cheios = eventosDescartados;
+    double s = duracao_us / 1e6;
+
+    printf("\n== Simulacao: %lu eventos em %.3f s (%.0f eventos/s) ==\n", (unsigned long)total, s, total / s);
+    for (int t = 0; t < SIM_TIPOS; t++)
+    {
+        printf("  %-12s %lu\n", NOMES[t], (unsigned long)injetados[t]);
+    }
+    printf("ISR: media %.2f us, max %lu us\n", total ? (double)isr_total_us / total : 0.0,
+           (unsigned long)isr_max_us);
+    printf("Processados pelas tarefas: %lu (%.0f eventos/s)\n", (unsigned long)feitos, feitos / s);
+    printf("Descartados com a fila cheia: %lu\n", (unsigned long)cheios);
+    printf("Descartados pelo reset (anteriores a ele): %ld\n", (long)botoes - (long)feitos - (long)cheios);
+    printf("Diario: %lu eventos perdidos no anel\n", (unsigned long)anelDiario.perdidos);
+    printf("Ocupacao final: %u\n", ocupacao_ler(&ocupacao));
+    rastreio_imprimir();
+}
+
+// Contexto de interrupção simulado: prioridade máxima, nunca preemptado
+// pelas tarefas da aplicação. A cada tick atende alarmes e DMA e injeta os
+// eventos que couberem no ritmo pedido.
+static void vTaskInjetor(void *params)
+{
+    vTaskDelay(pdMS_TO_TICKS(DEBOUNCE_MS + 50)); // Deixa o "boot" passar do debounce
+
+    uint32_t credito = 0;
+    uint32_t feitos = 0;
+    uint64_t inicio = time_us_64();
+    TickType_t tick = xTaskGetTickCount();
+    while (feitos < cfg.eventos)
+    {
+        sim_interrupcoes();
+        credito += cfg.taxa;
+        while (credito >= configTICK_RATE_HZ && feitos < cfg.eventos)
+        {
+            credito -= configTICK_RATE_HZ;
+            injetar(sortear());
+            feitos++;
+        }
+        vTaskDelayUntil(&tick, 1);
+    }
+    uint64_t duracao = time_us_64() - inicio;
+
+    for (uint32_t i = 0; i < pdMS_TO_TICKS(cfg.drenagem_ms); i++)
+    {
+        sim_interrupcoes();
+        vTaskDelay(1);
+    }
+
+    relatorio(duracao);
+    exit(0);
+}
+
+int main(int argc, char **argv)
+{
+    int opt;
+    while ((opt = getopt(argc, argv, "n:t:r:s:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            cfg.eventos = strtoul(optarg, NULL, 0);
+            break;
+        case 't':
+            cfg.taxa = strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            cfg.reset_cada = strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            cfg.semente = strtoul(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "uso: %s [-n eventos] [-t eventos/s] [-r reset a cada N] [-s semente]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (cfg.taxa == 0)
+    {
+        cfg.taxa = 1;
+    }
+
+    xTaskCreate(vTaskInjetor, "Injetor", configMINIMAL_STACK_SIZE + 256, NULL, configMAX_PRIORITIES - 1, NULL);
+    return app_main(); // Cria as tarefas da aplicação e inicia o escalonador
+}
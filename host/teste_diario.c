@@ -0,0 +1,211 @@
+/*
+ * Teste do diário de eventos (lib/diario.c) no PC, sobre flash_arquivo.
+ *
+ * Numa região de 4 setores (64 páginas) grava 1000 páginas, dando várias
+ * voltas, e confere:
+ *   - a leitura devolve os eventos em ordem e sem buracos, terminando no
+ *     último gravado;
+ *   - ao reabrir a região, a escrita continua na página e no seq certos;
+ *   - uma página gravada pela metade (reset no meio da gravação) é ignorada
+ *     na leitura e pulada na próxima escrita;
+ *   - com diario_preparar antes de cada página, diario_gravar não apaga
+ *     nenhum setor.
+ *
+ * Uso: teste_diario (cria teste_diario.bin no diretório atual)
+ */
+
+#include "diario.h"
+#include "flash_arquivo.h"
+#include <stdio.h>
+#include <string.h>
+
+#define ARQUIVO "teste_diario.bin"
+#define SETORES 4
+#define PAGINAS (SETORES * FLASH_OPS_SETOR / FLASH_OPS_PAGINA)
+#define VOLTAS 1000 // Páginas na primeira etapa
+
+static uint32_t falhas;
+
+#define CONFERIR(cond, ...)                              \
+    do                                                   \
+    {                                                    \
+        if (!(cond))                                     \
+        {                                                \
+            printf("FALHA %s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__);                         \
+            printf("\n");                                \
+            falhas++;                                    \
+        }                                                \
+    } while (0)
+
+// Backend que conta os apagamentos e repassa tudo ao arquivo
+typedef struct
+{
+    flash_ops_t *interno;
+    uint32_t apagamentos;
+} contagem_t;
+
+static bool contar_ler(const flash_ops_t *ops, uint32_t offset, void *destino, uint32_t n)
+{
+    contagem_t *c = ops->ctx;
+    return c->interno->ler(c->interno, offset, destino, n);
+}
+
+static bool contar_apagar(const flash_ops_t *ops, uint32_t offset)
+{
+    contagem_t *c = ops->ctx;
+    c->apagamentos++;
+    return c->interno->apagar(c->interno, offset);
+}
+
+static bool contar_programar(const flash_ops_t *ops, uint32_t offset, const void *origem)
+{
+    contagem_t *c = ops->ctx;
+    return c->interno->programar(c->interno, offset, origem);
+}
+
+static void abrir_contando(flash_ops_t *ops, contagem_t *c, flash_ops_t *interno)
+{
+    *c = (contagem_t){interno, 0};
+    *ops = (flash_ops_t){contar_ler, contar_apagar, contar_programar, c, interno->tamanho};
+}
+
+// Eventos numerados: tempo_ms é o número do evento desde o início do teste
+static uint32_t proximo_evento;
+
+static bool gravar(diario_t *diario, uint16_t n)
+{
+    diario_evento_t eventos[DIARIO_EVENTOS_PAGINA];
+    for (uint16_t i = 0; i < n; i++)
+    {
+        eventos[i] = (diario_evento_t){proximo_evento + i, DIARIO_ENTRADA, 0, (uint16_t)i};
+    }
+    if (!diario_gravar(diario, eventos, n, 0))
+    {
+        return false;
+    }
+    proximo_evento += n;
+    return true;
+}
+
+typedef struct
+{
+    uint32_t n;
+    uint32_t primeiro;
+    uint32_t ultimo;
+    uint32_t buracos; // Eventos fora de sequência
+} leitura_t;
+
+static bool visitar(const diario_evento_t *evento, uint32_t seq, void *ctx)
+{
+    (void)seq; // A ordem é conferida pelos próprios eventos
+    leitura_t *l = ctx;
+    if (l->n == 0)
+    {
+        l->primeiro = evento->tempo_ms;
+    }
+    else if (evento->tempo_ms != l->ultimo + 1)
+    {
+        l->buracos++;
+    }
+    l->ultimo = evento->tempo_ms;
+    l->n++;
+    return true;
+}
+
+// Lê o diário inteiro e confere ordem, continuidade e o último evento
+static void conferir_leitura(const diario_t *diario, uint32_t minimo, const char *etapa)
+{
+    leitura_t l = {0};
+    diario_percorrer(diario, visitar, &l);
+    CONFERIR(l.buracos == 0, "%s: %lu eventos fora de ordem", etapa, (unsigned long)l.buracos);
+    CONFERIR(l.n > 0 && l.ultimo == proximo_evento - 1, "%s: ultimo %lu, esperado %lu", etapa,
+             (unsigned long)l.ultimo, (unsigned long)(proximo_evento - 1));
+    CONFERIR(l.n >= minimo, "%s: %lu eventos lidos, esperado ao menos %lu", etapa, (unsigned long)l.n,
+             (unsigned long)minimo);
+    printf("%-12s %5lu eventos (%lu a %lu)\n", etapa, (unsigned long)l.n, (unsigned long)l.primeiro,
+           (unsigned long)l.ultimo);
+}
+
+int main(void)
+{
+    flash_ops_t arquivo;
+    diario_t diario;
+    const uint32_t paginas_setor = FLASH_OPS_SETOR / FLASH_OPS_PAGINA;
+
+    remove(ARQUIVO);
+    if (!flash_ops_arquivo(&arquivo, ARQUIVO, SETORES * FLASH_OPS_SETOR))
+    {
+        printf("FALHA: nao foi possivel criar %s\n", ARQUIVO);
+        return 1;
+    }
+
+    // Região nova, várias voltas com páginas de tamanhos variados
+    CONFERIR(diario_abrir(&diario, &arquivo), "abrir regiao nova");
+    CONFERIR(diario.seq == 1 && diario.proxima == 0, "regiao nova: seq %lu, proxima %lu",
+             (unsigned long)diario.seq, (unsigned long)diario.proxima);
+    uint32_t gravadas = 0;
+    for (uint32_t i = 0; i < VOLTAS; i++)
+    {
+        gravadas += gravar(&diario, (uint16_t)(i % DIARIO_EVENTOS_PAGINA + 1));
+    }
+    CONFERIR(gravadas == VOLTAS, "%lu de %u paginas gravadas", (unsigned long)gravadas, VOLTAS);
+    CONFERIR(diario.erros == 0, "%lu erros de gravacao", (unsigned long)diario.erros);
+    conferir_leitura(&diario, PAGINAS - paginas_setor, "voltas");
+
+    // Reabrir: continua logo após a página mais recente
+    flash_ops_arquivo_fechar(&arquivo);
+    flash_ops_arquivo(&arquivo, ARQUIVO, SETORES * FLASH_OPS_SETOR);
+    diario_abrir(&diario, &arquivo);
+    CONFERIR(diario.seq == VOLTAS + 1, "reaberto: seq %lu, esperado %u", (unsigned long)diario.seq, VOLTAS + 1);
+    CONFERIR(diario.proxima == VOLTAS % PAGINAS, "reaberto: proxima %lu, esperado %u",
+             (unsigned long)diario.proxima, VOLTAS % PAGINAS);
+    CONFERIR(gravar(&diario, 5), "gravar apos reabrir");
+    conferir_leitura(&diario, 1, "reaberto");
+
+    // Página rasgada: cabeçalho gravado, eventos ainda em 0xFF, CRC errado
+    diario_pagina_t rasgada;
+    uint32_t indice = diario.proxima;
+    uint32_t seq = diario.seq;
+    memset(&rasgada, 0xFF, sizeof(rasgada));
+    rasgada.cab = (diario_cabecalho_t){DIARIO_MAGICO, seq, DIARIO_EVENTOS_PAGINA, 0, 0x12345678u};
+    if (indice % paginas_setor == 0)
+    {
+        arquivo.apagar(&arquivo, indice * FLASH_OPS_PAGINA);
+    }
+    arquivo.programar(&arquivo, indice * FLASH_OPS_PAGINA, &rasgada);
+    flash_ops_arquivo_fechar(&arquivo);
+    flash_ops_arquivo(&arquivo, ARQUIVO, SETORES * FLASH_OPS_SETOR);
+    diario_abrir(&diario, &arquivo);
+    CONFERIR(diario.seq == seq && diario.proxima == indice, "rasgada: seq %lu proxima %lu, esperado %lu %lu",
+             (unsigned long)diario.seq, (unsigned long)diario.proxima, (unsigned long)seq, (unsigned long)indice);
+    conferir_leitura(&diario, 1, "rasgada");
+    CONFERIR(gravar(&diario, 3), "gravar apos pagina rasgada");
+    CONFERIR(diario.proxima == (indice + 2) % PAGINAS, "rasgada: a escrita devia pular a pagina %lu",
+             (unsigned long)indice);
+    conferir_leitura(&diario, 1, "pulada");
+
+    // Apagamento adiantado: diario_gravar não apaga mais nada
+    flash_ops_t contando;
+    contagem_t contagem;
+    abrir_contando(&contando, &contagem, &arquivo);
+    diario_abrir(&diario, &contando);
+    uint32_t apagamentos_gravando = 0;
+    for (uint32_t i = 0; i < 3 * PAGINAS; i++)
+    {
+        CONFERIR(diario_preparar(&diario), "diario_preparar");
+        uint32_t antes = contagem.apagamentos;
+        CONFERIR(gravar(&diario, DIARIO_EVENTOS_PAGINA), "gravar com setor preparado");
+        apagamentos_gravando += contagem.apagamentos - antes;
+    }
+    CONFERIR(apagamentos_gravando == 0, "%lu apagamentos dentro de diario_gravar", (unsigned long)apagamentos_gravando);
+    // Um por setor atravessado, mais o que fica apagado à frente
+    CONFERIR(contagem.apagamentos <= 3 * SETORES + 1, "%lu apagamentos adiantados, esperado ate %u",
+             (unsigned long)contagem.apagamentos, 3 * SETORES + 1);
+    conferir_leitura(&diario, (PAGINAS - 2 * paginas_setor) * DIARIO_EVENTOS_PAGINA, "preparado");
+
+    flash_ops_arquivo_fechar(&arquivo);
+    remove(ARQUIVO);
+    printf("%s\n", falhas ? "FALHOU" : "ok");
+    return falhas ? 1 : 0;
+}
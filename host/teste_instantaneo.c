@@ -0,0 +1,150 @@
+/*
+ * Teste do instantâneo da ocupação (lib/instantaneo.c) no PC, sobre
+ * flash_arquivo.
+ *
+ * O módulo é incluído direto para o teste poder estragar a cópia em RAM,
+ * como numa partida a frio, e conferir a posição de escrita. Numa região de
+ * dois setores (512 registros) confere:
+ *   - flash em branco e RAM com lixo: nada é restaurado;
+ *   - 1300 mudanças gravadas, dando a volta nos setores: a partida a frio
+ *     volta ao último valor gravado e a escrita continua logo depois dele;
+ *   - partida a quente com uma mudança ainda não gravada: vence a RAM;
+ *   - último registro corrompido: recua para o anterior; os
+ *     INSTANTANEO_RECUOS últimos corrompidos: vale o último do outro setor.
+ *
+ * Uso: teste_instantaneo (cria teste_instantaneo.bin no diretório atual)
+ */
+
+#include "instantaneo.c"
+#include "flash_arquivo.h"
+#include <stdio.h>
+
+#define ARQUIVO "teste_instantaneo.bin"
+#define TAMANHO (2 * FLASH_OPS_SETOR)
+#define MUDANCAS 1300
+
+static uint32_t falhas;
+
+#define CONFERIR(cond, ...)                              \
+    do                                                   \
+    {                                                    \
+        if (!(cond))                                     \
+        {                                                \
+            printf("FALHA %s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__);                         \
+            printf("\n");                                \
+            falhas++;                                    \
+        }                                                \
+    } while (0)
+
+static flash_ops_t arquivo;
+static uint16_t gravado[TAMANHO / sizeof(instantaneo_t)]; // Valor de cada registro na flash
+
+static const char *const ORIGENS[] = {"nenhum", "RAM", "flash"};
+
+// Partida a frio: a RAM não inicializada vem com lixo
+static void perder_ram(void)
+{
+    memset(&instantaneo_ram, 0xA5, sizeof(instantaneo_ram));
+}
+
+// Reabre o arquivo e restaura, como na partida
+static instantaneo_origem_t partir(uint16_t *usuarios)
+{
+    flash_ops_arquivo_fechar(&arquivo);
+    flash_ops_arquivo(&arquivo, ARQUIVO, TAMANHO);
+    return instantaneo_restaurar(&arquivo, usuarios);
+}
+
+static void conferir_partida(instantaneo_origem_t esperada, uint16_t valor, const char *etapa)
+{
+    uint16_t usuarios = 0xFFFF;
+    instantaneo_origem_t origem = partir(&usuarios);
+    CONFERIR(origem == esperada && usuarios == valor, "%s: %s com %u, esperado %s com %u", etapa, ORIGENS[origem],
+             usuarios, ORIGENS[esperada], valor);
+    printf("%-22s %-6s %4u\n", etapa, ORIGENS[origem], usuarios);
+}
+
+// Muda a ocupação e grava na flash, anotando o valor do registro
+static bool mudar_e_gravar(uint16_t usuarios)
+{
+    uint32_t registro = proximo;
+    instantaneo_atualizar(usuarios);
+    if (!instantaneo_gravar_flash())
+    {
+        return false;
+    }
+    gravado[registro] = usuarios;
+    return true;
+}
+
+// Zera o CRC do registro na flash (gravar só leva bits a 0, como na NOR)
+static void corromper(uint32_t registro)
+{
+    uint8_t pagina[FLASH_OPS_PAGINA];
+    uint32_t offset = registro * sizeof(instantaneo_t);
+    uint32_t pos = offset % FLASH_OPS_PAGINA;
+    memset(pagina, 0xFF, sizeof(pagina));
+    memset(&pagina[pos + offsetof(instantaneo_t, crc)], 0, sizeof(uint32_t));
+    arquivo.programar(&arquivo, offset - pos, pagina);
+}
+
+int main(void)
+{
+    remove(ARQUIVO);
+    if (!flash_ops_arquivo(&arquivo, ARQUIVO, TAMANHO))
+    {
+        printf("FALHA: nao foi possivel criar %s\n", ARQUIVO);
+        return 1;
+    }
+
+    perder_ram();
+    conferir_partida(INSTANTANEO_NENHUM, 0, "em branco");
+
+    // Várias voltas pelos dois setores
+    uint32_t gravadas = 0;
+    for (uint32_t i = 1; i <= MUDANCAS; i++)
+    {
+        gravadas += mudar_e_gravar((uint16_t)i);
+    }
+    CONFERIR(gravadas == MUDANCAS, "%lu de %u registros gravados", (unsigned long)gravadas, MUDANCAS);
+    CONFERIR(!instantaneo_gravar_flash(), "sem mudanca nao devia gravar");
+    uint32_t continuar = proximo;
+
+    // A quente com tudo gravado: RAM e flash empatam e vale a flash
+    conferir_partida(INSTANTANEO_FLASH, MUDANCAS, "quente, tudo gravado");
+
+    // A frio: a escrita continua logo após o último registro
+    perder_ram();
+    conferir_partida(INSTANTANEO_FLASH, MUDANCAS, "frio");
+    CONFERIR(proximo == continuar, "frio: proximo %lu, esperado %lu", (unsigned long)proximo,
+             (unsigned long)continuar);
+
+    // A quente com uma mudança ainda só na RAM
+    instantaneo_atualizar(7);
+    conferir_partida(INSTANTANEO_RAM, 7, "quente, nao gravado");
+    CONFERIR(mudar_e_gravar(8), "gravar apos partida a quente");
+
+    // Último registro corrompido: recua um
+    uint32_t ultimo = proximo - 1;
+    uint32_t no_setor = ultimo % REGISTROS_SETOR;
+    CONFERIR(no_setor + 1 > INSTANTANEO_RECUOS, "o teste precisa de %u registros no setor atual",
+             INSTANTANEO_RECUOS + 1);
+    corromper(ultimo);
+    perder_ram();
+    conferir_partida(INSTANTANEO_FLASH, gravado[ultimo - 1], "ultimo corrompido");
+
+    // Os INSTANTANEO_RECUOS últimos corrompidos: vale o fim do outro setor
+    for (uint32_t k = 1; k < INSTANTANEO_RECUOS; k++)
+    {
+        corromper(ultimo - k);
+    }
+    uint32_t outro = (ultimo / REGISTROS_SETOR + 1) % (TAMANHO / FLASH_OPS_SETOR);
+    perder_ram();
+    conferir_partida(INSTANTANEO_FLASH, gravado[outro * REGISTROS_SETOR + REGISTROS_SETOR - 1], "recuos esgotados");
+
+    flash_ops_arquivo_fechar(&arquivo);
+    remove(ARQUIVO);
+    printf("%s\n", falhas ? "FALHOU" : "ok");
+    return falhas ? 1 : 0;
+}
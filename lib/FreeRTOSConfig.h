@@ -42,7 +42,15 @@
  
  /* Scheduler Related */
  #define configUSE_PREEMPTION                    1
+ /* Com -DECONOMIA=ON a tarefa ociosa para o tick e dorme (WFI) até a
+  * próxima tarefa com prazo ou uma interrupção; as bordas dos botões e do
+  * joystick acordam o núcleo pela IRQ de GPIO, que fica sempre habilitada. */
+ #ifdef ECONOMIA
+ #define configUSE_TICKLESS_IDLE                 1
+ #define configEXPECTED_IDLE_TIME_BEFORE_SLEEP   2
+ #else
  #define configUSE_TICKLESS_IDLE                 0
+ #endif
  #define configUSE_IDLE_HOOK                     0
  #define configUSE_TICK_HOOK                     0
  #define configTICK_RATE_HZ                      ( ( TickType_t ) 1000 )
@@ -69,18 +77,44 @@
  #define configMESSAGE_BUFFER_LENGTH_TYPE        size_t
  
  /* Memory allocation related definitions. */
+ /* Com -DESTATICO=ON toda tarefa, fila e semáforo tem memória estática
+  * (lib/estatico.h) e o build não tem heap do FreeRTOS. */
+ #ifdef ESTATICO
+ #define configSUPPORT_STATIC_ALLOCATION         1
+ #define configSUPPORT_DYNAMIC_ALLOCATION        0
+ #else
  #define configSUPPORT_STATIC_ALLOCATION         0
  #define configSUPPORT_DYNAMIC_ALLOCATION        1
+ #endif
  #define configTOTAL_HEAP_SIZE                   (128*1024)
  #define configAPPLICATION_ALLOCATED_HEAP        0
  
  /* Hook function related definitions. */
- #define configCHECK_FOR_STACK_OVERFLOW          0
+ #define configCHECK_FOR_STACK_OVERFLOW          2 /* Gancho em perfil.c */
  #define configUSE_MALLOC_FAILED_HOOK            0
  #define configUSE_DAEMON_TASK_STARTUP_HOOK      0
  
  /* Run time and task stats gathering related definitions. */
+ /* Com -DPERFIL=ON o tempo de CPU vem do timer de 1 us (perfil.c); o
+  * timer já roda desde o boot, então não há o que configurar. */
+ #ifdef PERFIL
+ #define configGENERATE_RUN_TIME_STATS           1
+ #ifndef __ASSEMBLER__
+ extern uint32_t perfil_contador_us(void);
+ extern void perfil_fila_nivel(void *fila, uint32_t nivel);
+ #endif
+ #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+ #define portGET_RUN_TIME_COUNTER_VALUE()        perfil_contador_us()
+ /* Pico das filas: cada envio informa a ocupação logo após a cópia (a
+  * sobrescrita de uma fila cheia não passa do tamanho). Expande em queue.c,
+  * dentro da seção crítica da fila. */
+ #define PERFIL_NIVEL_APOS_ENVIO(q) \
+     ((q)->uxMessagesWaiting < (q)->uxLength ? (q)->uxMessagesWaiting + 1 : (q)->uxLength)
+ #define traceQUEUE_SEND(pxQueue)                perfil_fila_nivel((pxQueue), PERFIL_NIVEL_APOS_ENVIO(pxQueue))
+ #define traceQUEUE_SEND_FROM_ISR(pxQueue)       perfil_fila_nivel((pxQueue), PERFIL_NIVEL_APOS_ENVIO(pxQueue))
+ #else
  #define configGENERATE_RUN_TIME_STATS           0
+ #endif
  #define configUSE_TRACE_FACILITY                1
  #define configUSE_STATS_FORMATTING_FUNCTIONS    0
  
@@ -102,8 +136,22 @@
  */
  
  /* SMP port only */
+ /* Com -DDOIS_NUCLEOS=ON o port SMP do RP2040 usa os dois núcleos e cada
+  * tarefa é presa ao seu (vTaskCoreAffinitySet no programa principal). */
+ #if defined(DOIS_NUCLEOS) && defined(ECONOMIA)
+ #error "O tickless idle do port do RP2040 só existe com um núcleo: use DOIS_NUCLEOS ou ECONOMIA"
+ #endif
+ #ifdef DOIS_NUCLEOS
+ #define configNUMBER_OF_CORES                   2
+ #define configNUM_CORES                         configNUMBER_OF_CORES
+ #define configTICK_CORE                         0
+ #define configUSE_CORE_AFFINITY                 1
+ #define configUSE_PASSIVE_IDLE_HOOK             0
+ #define configUSE_MINIMAL_IDLE_HOOK             0
+ #else
  #define configNUM_CORES                         1
  #define configTICK_CORE                         1
+ #endif
  #define configRUN_MULTIPLE_PRIORITIES           1
  
  /* RP2040 specific */
@@ -134,5 +182,11 @@
  #define INCLUDE_xQueueGetMutexHolder            1
  
  /* A header file that defines trace macro can be included here. */
+
+ /* Contador de trocas de contexto usado pelo benchmark de despacho */
+ #if defined(BENCH_DESPACHO) && !defined(__ASSEMBLER__)
+ extern volatile uint32_t ulTrocasDeContexto;
+ #define traceTASK_SWITCHED_IN()                 ulTrocasDeContexto++
+ #endif
  
  #endif /* FREERTOS_CONFIG_H */
\ No newline at end of file
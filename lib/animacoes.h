@@ -1,241 +1,209 @@
 #include "matrizled.c"
 #include "FreeRTOS.h"
 #include "task.h"
-#include "semphr.h"
-
-// Matriz RESET_PISCA (vermelha, intensidade 10)
-int RESET_PISCAO[5][5][3] = {
-    {{10, 0, 0}, {10, 0, 0}, {10, 0, 0}, {10, 0, 0}, {10, 0, 0}},
-    {{10, 0, 0}, {10, 0, 0}, {10, 0, 0}, {10, 0, 0}, {10, 0, 0}},
-    {{10, 0, 0}, {10, 0, 0}, {10, 0, 0}, {10, 0, 0}, {10, 0, 0}},
-    {{10, 0, 0}, {10, 0, 0}, {10, 0, 0}, {10, 0, 0}, {10, 0, 0}},
-    {{10, 0, 0}, {10, 0, 0}, {10, 0, 0}, {10, 0, 0}, {10, 0, 0}}};
-
-// Frames de animação do boneco (vermelho, saída, intensidade 10)
-int BonecoFrame1[5][5][3] = {
-    {{10, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{10, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{10, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}}};
-
-int BonecoFrame2[5][5][3] = {
-    {{0, 0, 0}, {10, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{10, 0, 0}, {10, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{10, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{10, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}}};
-
-int BonecoFrame3[5][5][3] = {
-    {{10, 0, 0}, {0, 0, 0}, {10, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{10, 0, 0}, {10, 0, 0}, {10, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{10, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {10, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {10, 0, 0}, {0, 0, 0}, {0, 0, 0}}};
-
-int BonecoFrame4[5][5][3] = {
-    {{0, 0, 0}, {10, 0, 0}, {0, 0, 0}, {10, 0, 0}, {0, 0, 0}},
-    {{10, 0, 0}, {10, 0, 0}, {10, 0, 0}, {10, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {10, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{10, 0, 0}, {0, 0, 0}, {10, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {10, 0, 0}, {0, 0, 0}, {0, 0, 0}}};
-
-int BonecoFrame5[5][5][3] = {
-    {{10, 0, 0}, {0, 0, 0}, {10, 0, 0}, {0, 0, 0}, {10, 0, 0}},
-    {{10, 0, 0}, {10, 0, 0}, {10, 0, 0}, {10, 0, 0}, {10, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {10, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {10, 0, 0}, {0, 0, 0}, {10, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {10, 0, 0}, {0, 0, 0}, {0, 0, 0}, {10, 0, 0}}};
-
-int BonecoFrame6[5][5][3] = {
-    {{0, 0, 0}, {10, 0, 0}, {0, 0, 0}, {10, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {10, 0, 0}, {10, 0, 0}, {10, 0, 0}, {10, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {10, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {10, 0, 0}, {0, 0, 0}, {10, 0, 0}},
-    {{0, 0, 0}, {10, 0, 0}, {0, 0, 0}, {0, 0, 0}, {10, 0, 0}}};
-
-int BonecoFrame7[5][5][3] = {
-    {{0, 0, 0}, {0, 0, 0}, {10, 0, 0}, {0, 0, 0}, {10, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {10, 0, 0}, {10, 0, 0}, {10, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {10, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {10, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {10, 0, 0}, {0, 0, 0}}};
-
-int BonecoFrame8[5][5][3] = {
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {10, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {10, 0, 0}, {10, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {10, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {10, 0, 0}, {0, 0, 0}}};
-
-int BonecoFrame9[5][5][3] = {
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {10, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {10, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}}};
-
-// Frames de animação do boneco (verde, entrada, intensidade 10)
-int BonecoEntradaFrame1[5][5][3] = {
-    {{0, 10, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 10, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 10, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}}};
-
-int BonecoEntradaFrame2[5][5][3] = {
-    {{0, 0, 0}, {0, 10, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 10, 0}, {0, 10, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 10, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 10, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}}};
-
-int BonecoEntradaFrame3[5][5][3] = {
-    {{0, 10, 0}, {0, 0, 0}, {0, 10, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 10, 0}, {0, 10, 0}, {0, 10, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 10, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 10, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 10, 0}, {0, 0, 0}, {0, 0, 0}}};
-
-int BonecoEntradaFrame4[5][5][3] = {
-    {{0, 0, 0}, {0, 10, 0}, {0, 0, 0}, {0, 10, 0}, {0, 0, 0}},
-    {{0, 10, 0}, {0, 10, 0}, {0, 10, 0}, {0, 10, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 10, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 10, 0}, {0, 0, 0}, {0, 10, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 10, 0}, {0, 0, 0}, {0, 0, 0}}};
-
-int BonecoEntradaFrame5[5][5][3] = {
-    {{0, 10, 0}, {0, 0, 0}, {0, 10, 0}, {0, 0, 0}, {0, 10, 0}},
-    {{0, 10, 0}, {0, 10, 0}, {0, 10, 0}, {0, 10, 0}, {0, 10, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 10, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 10, 0}, {0, 0, 0}, {0, 10, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 10, 0}, {0, 0, 0}, {0, 0, 0}, {0, 10, 0}}};
-
-int BonecoEntradaFrame6[5][5][3] = {
-    {{0, 0, 0}, {0, 10, 0}, {0, 0, 0}, {0, 10, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 10, 0}, {0, 10, 0}, {0, 10, 0}, {0, 10, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 10, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 10, 0}, {0, 0, 0}, {0, 10, 0}},
-    {{0, 0, 0}, {0, 10, 0}, {0, 0, 0}, {0, 0, 0}, {0, 10, 0}}};
-
-int BonecoEntradaFrame7[5][5][3] = {
-    {{0, 0, 0}, {0, 0, 0}, {0, 10, 0}, {0, 0, 0}, {0, 10, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 10, 0}, {0, 10, 0}, {0, 10, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 10, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 10, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 10, 0}, {0, 0, 0}}};
-
-int BonecoEntradaFrame8[5][5][3] = {
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 10, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 10, 0}, {0, 10, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 10, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 10, 0}, {0, 0, 0}}};
-
-int BonecoEntradaFrame9[5][5][3] = {
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 10, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 10, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-    {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}}};
-
-// Função para desenhar um frame específico
-void desenhaFrame(int frame[5][5][3])
+#include "queue.h"
+#include "perfil.h"
+#include "estatico.h"
+
+// Função para desenhar um frame específico. O sprite ocupa o canto de
+// SPRITE_LADO x SPRITE_LADO; numa matriz maior o resto é apagado antes, senão
+// guardaria as cores da grade ou do quadro anterior.
+void desenhaFrame(const sprite_t *frame, const cor_t *paleta)
 {
-    npClear();
-    for (int row = 0; row < 5; row++)
+    if (NP_PIXELS > SPRITE_PIXELS)
     {
-        for (int col = 0; col < 5; col++)
-        {
-            int posicao = getIndex(col, row);
-            npSetLED(posicao, frame[row][col][0], frame[row][col][1], frame[row][col][2]);
-        }
+        npClear();
     }
+    desenhaSprite(frame, paleta);
     npWrite();
 }
 
-// Animação de entrada (verde, Frame1 a Frame9)
-void anim_entrada(SemaphoreHandle_t xMatrixMutex)
+// ---------------------------------------------------------------------------
+// Motor de animações
+//
+// Uma tarefa dedicada é a única dona da matriz. As outras tarefas só pedem
+// animações com anim_solicitar, que retorna na hora. Os quadros avançam num
+// passo fixo de tempo (vTaskDelayUntil implícito pelo tempo do próximo
+// passo). Política de fila: um pedido com prioridade maior ou igual à da
+// animação em curso a interrompe (ex.: reset corta a entrada); um de menor
+// prioridade fica guardado numa vaga única (o mais recente vence) e toca
+// quando a atual terminar.
+// ---------------------------------------------------------------------------
+
+typedef enum
 {
-    if (xSemaphoreTake(xMatrixMutex, portMAX_DELAY) == pdTRUE)
-    {
-        int (*frames[9])[5][3] = {BonecoEntradaFrame1, BonecoEntradaFrame2, BonecoEntradaFrame3,
-                                  BonecoEntradaFrame4, BonecoEntradaFrame5, BonecoEntradaFrame6,
-                                  BonecoEntradaFrame7, BonecoEntradaFrame8, BonecoEntradaFrame9};
-        for (int f = 0; f < 9; f++)
-        {
-            desenhaFrame(frames[f]);
-            vTaskDelay(pdMS_TO_TICKS(100)); // 10 Hz
+    ANIM_CONTAGEM, // Grade de contagem (sem animação de evento)
+    ANIM_ENTRADA,
+    ANIM_SAIDA,
+    ANIM_RESET
+} AnimacaoId;
+
+typedef struct
+{
+    AnimacaoId id;
+    uint16_t usuarios; // Usado pela grade de contagem
+    RASTREIO_CAMPO(uint16_t seq;) // Evento de origem, para o rastreio
+} AnimPedido;
+
+// Um passo: quadro a exibir (NULL apaga a matriz), sua paleta e quanto
+// tempo mantê-lo
+typedef struct
+{
+    const sprite_t *frame;
+    const cor_t *paleta;
+    uint16_t duracao_ms;
+} AnimPasso;
+
+typedef struct
+{
+    const AnimPasso *passos; // NULL: grade de contagem
+    uint8_t n_passos;
+    uint8_t prioridade;
+} Animacao;
+
+// Entrada (verde, quadros 1 a 9)
+static const AnimPasso PASSOS_ENTRADA[] = {
+    {&BONECO[0], PALETA_VERDE, 100}, {&BONECO[1], PALETA_VERDE, 100}, {&BONECO[2], PALETA_VERDE, 100},
+    {&BONECO[3], PALETA_VERDE, 100}, {&BONECO[4], PALETA_VERDE, 100}, {&BONECO[5], PALETA_VERDE, 100},
+    {&BONECO[6], PALETA_VERDE, 100}, {&BONECO[7], PALETA_VERDE, 100}, {&BONECO[8], PALETA_VERDE, 100},
+    {NULL, NULL, 200}};
+
+// Saída (vermelho, quadros 9 a 1)
+static const AnimPasso PASSOS_SAIDA[] = {
+    {&BONECO[8], PALETA_VERMELHA, 100}, {&BONECO[7], PALETA_VERMELHA, 100}, {&BONECO[6], PALETA_VERMELHA, 100},
+    {&BONECO[5], PALETA_VERMELHA, 100}, {&BONECO[4], PALETA_VERMELHA, 100}, {&BONECO[3], PALETA_VERMELHA, 100},
+    {&BONECO[2], PALETA_VERMELHA, 100}, {&BONECO[1], PALETA_VERMELHA, 100}, {&BONECO[0], PALETA_VERMELHA, 100},
+    {NULL, NULL, 200}};
+
+// Reset (piscar vermelho 3 vezes)
+static const AnimPasso PASSOS_RESET[] = {
+    {&SPRITE_CHEIO, PALETA_VERMELHA, 100}, {NULL, NULL, 100},
+    {&SPRITE_CHEIO, PALETA_VERMELHA, 100}, {NULL, NULL, 100},
+    {&SPRITE_CHEIO, PALETA_VERMELHA, 100}, {NULL, NULL, 300}};
+
+#define ANIM_CONTAGEM_MS 200
+
+static const Animacao ANIMACOES[] = {
+    [ANIM_CONTAGEM] = {NULL, 1, 1},
+    [ANIM_ENTRADA] = {PASSOS_ENTRADA, sizeof(PASSOS_ENTRADA) / sizeof(AnimPasso), 2},
+    [ANIM_SAIDA] = {PASSOS_SAIDA, sizeof(PASSOS_SAIDA) / sizeof(AnimPasso), 2},
+    [ANIM_RESET] = {PASSOS_RESET, sizeof(PASSOS_RESET) / sizeof(AnimPasso), 3},
+};
+
+static QueueHandle_t xAnimFila;
+
+// Grade de contagem: acende 'usuariosAtivos' LEDs
+void desenhaContagem(int usuariosAtivos)
+{
+    npClear(); // Limpa a matriz
+    for (int i = 0; i < NP_PIXELS; i++)
+    { // Percorre todos os LEDs da geometria
+        if (i < usuariosAtivos)
+        { // Acende até usuariosAtivos LEDs
+            if (usuariosAtivos >= NP_PIXELS)
+            {
+                npSetLEDCor(i, &PALETA_VERMELHA[1]); // Vermelho na lotação máxima
+            }
+            else
+            {
+                npSetLEDCor(i, &PALETA_VERDE[1]); // Verde para contagem normal
+            }
         }
-        npClear();
-        npWrite();
-        vTaskDelay(pdMS_TO_TICKS(200)); // 10 Hz
-        xSemaphoreGive(xMatrixMutex);
     }
+    npWrite(); // Atualiza a matriz
 }
 
-// Animação de saída (vermelho, Frame9 a Frame1)
-void anim_saida(SemaphoreHandle_t xMatrixMutex)
+// Exibe o passo 'passo' do pedido e retorna por quanto tempo mantê-lo
+static uint16_t anim_exibir_passo(const AnimPedido *pedido, uint8_t passo)
 {
-    if (xSemaphoreTake(xMatrixMutex, portMAX_DELAY) == pdTRUE)
+    const Animacao *anim = &ANIMACOES[pedido->id];
+    if (anim->passos == NULL)
     {
-        int (*frames[9])[5][3] = {BonecoFrame9, BonecoFrame8, BonecoFrame7, BonecoFrame6,
-                                  BonecoFrame5, BonecoFrame4, BonecoFrame3, BonecoFrame2,
-                                  BonecoFrame1};
-        for (int f = 0; f < 9; f++)
-        {
-            desenhaFrame(frames[f]);
-            vTaskDelay(pdMS_TO_TICKS(100)); // 10 Hz
-        }
-        npClear();
-        npWrite();
-        vTaskDelay(pdMS_TO_TICKS(200)); // 10 Hz
-        xSemaphoreGive(xMatrixMutex);
+        desenhaContagem(pedido->usuarios);
+        return ANIM_CONTAGEM_MS;
     }
-}
 
-// Animação de reset
-void anim_reset(SemaphoreHandle_t xMatrixMutex)
-{
-    if (xSemaphoreTake(xMatrixMutex, portMAX_DELAY) == pdTRUE)
+    const AnimPasso *p = &anim->passos[passo];
+    if (p->frame)
+    {
+        desenhaFrame(p->frame, p->paleta);
+    }
+    else
     {
-        for (int i = 0; i < 3; i++)
-        {
-            desenhaFrame(RESET_PISCAO);
-            vTaskDelay(pdMS_TO_TICKS(100));
-            npClear();
-            npWrite();
-            vTaskDelay(pdMS_TO_TICKS(100));
-        }
         npClear();
         npWrite();
-        vTaskDelay(pdMS_TO_TICKS(200)); // 10 Hz
-        xSemaphoreGive(xMatrixMutex);
     }
+    return p->duracao_ms;
 }
 
-// Animação de contagem
-void anim_contagem(int usuariosAtivos, SemaphoreHandle_t xMatrixMutex)
+// Tarefa do motor de animações
+void vTaskAnimacao(void *params)
 {
-    if (xSemaphoreTake(xMatrixMutex, portMAX_DELAY) == pdTRUE)
+    AnimPedido atual, pendente, novo;
+    bool tocando = false, temPendente = false;
+    uint8_t passo = 0;
+    TickType_t proximo = 0;
+
+    while (true)
     {
-        npClear(); // Limpa a matriz
-        for (int i = 0; i < 25; i++)
-        { // Percorre os 25 LEDs
-            if (i < usuariosAtivos)
-            { // Acende até usuariosAtivos LEDs
-                if (usuariosAtivos == 25)
-                {
-                    npSetLED(i, 10, 0, 0); // Vermelho na lotação máxima
-                }
-                else
-                {
-                    npSetLED(i, 0, 10, 0); // Verde para contagem normal
-                }
+        TickType_t espera = portMAX_DELAY;
+        if (tocando)
+        {
+            TickType_t agora = xTaskGetTickCount();
+            espera = (int32_t)(proximo - agora) > 0 ? proximo - agora : 0;
+        }
+
+        if (xQueueReceive(xAnimFila, &novo, espera) == pdTRUE)
+        {
+            if (tocando && ANIMACOES[novo.id].prioridade < ANIMACOES[atual.id].prioridade)
+            {
+                pendente = novo; // Espera a atual terminar
+                temPendente = true;
+                continue;
             }
+            atual = novo; // Começa agora (interrompe a atual, se houver)
+            passo = 0;
+            tocando = true;
+            RASTREIO_SO(npRastrear(atual.seq);)
+            proximo = xTaskGetTickCount() + pdMS_TO_TICKS(anim_exibir_passo(&atual, passo));
+            continue;
+        }
+
+        // Tempo do passo atual esgotado: avança no passo fixo
+        if (++passo < ANIMACOES[atual.id].n_passos)
+        {
+            proximo += pdMS_TO_TICKS(anim_exibir_passo(&atual, passo));
+        }
+        else if (temPendente)
+        {
+            atual = pendente;
+            temPendente = false;
+            passo = 0;
+            RASTREIO_SO(npRastrear(atual.seq);)
+            proximo = xTaskGetTickCount() + pdMS_TO_TICKS(anim_exibir_passo(&atual, passo));
+        }
+        else
+        {
+            tocando = false;
         }
-        npWrite();                      // Atualiza a matriz
-        vTaskDelay(pdMS_TO_TICKS(200)); // 10 Hz
-        xSemaphoreGive(xMatrixMutex);   // Libera o mutex
     }
 }
+
+// Cria a fila de pedidos e a tarefa do motor, cujo handle retorna
+TaskHandle_t anim_iniciar(UBaseType_t prioridade)
+{
+    TaskHandle_t tarefa = NULL;
+    CRIAR_FILA(xAnimFila, 4, AnimPedido);
+    perfil_registrar_fila(xAnimFila, "animacao");
+    CRIAR_TAREFA(vTaskAnimacao, "AnimTask", configMINIMAL_STACK_SIZE + 128, NULL, prioridade, &tarefa);
+    return tarefa;
+}
+
+// Pede uma animação sem bloquear. Se a fila de pedidos estiver cheia o
+// pedido é descartado (a próxima atualização de estado gera outro).
+bool anim_solicitar(AnimacaoId id, uint16_t usuarios, uint16_t seq)
+{
+    AnimPedido pedido = {id, usuarios};
+    RASTREIO_SO(pedido.seq = seq;)
+    return xQueueSend(xAnimFila, &pedido, 0) == pdTRUE;
+}
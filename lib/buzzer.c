@@ -0,0 +1,130 @@
+#include "buzzer.h"
+#include "hardware/pwm.h"
+#include "hardware/clocks.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "perfil.h"
+#include "estatico.h"
+
+#define BUZZER_FILA 4 // Padrões aguardando
+
+#define NOTAS(n) (sizeof(n) / sizeof(buzzer_nota_t))
+
+// Dois tons descendentes: "não cabe mais ninguém"
+static const buzzer_nota_t NOTAS_CAPACIDADE[] = {{880, 120, 40}, {440, 250, 0}};
+// Um bipe agudo e curto: "não há quem sair"
+static const buzzer_nota_t NOTAS_NENHUM[] = {{1500, 80, 0}};
+// Beep duplo de 1000 Hz (o alerta de reset de sempre)
+static const buzzer_nota_t NOTAS_RESET[] = {{1000, 100, 100}, {1000, 100, 0}};
+
+const buzzer_padrao_t BUZZER_CAPACIDADE = {NOTAS_CAPACIDADE, NOTAS(NOTAS_CAPACIDADE)};
+const buzzer_padrao_t BUZZER_NENHUM = {NOTAS_NENHUM, NOTAS(NOTAS_NENHUM)};
+const buzzer_padrao_t BUZZER_RESET = {NOTAS_RESET, NOTAS(NOTAS_RESET)};
+
+static uint buzzer_pino;
+static uint buzzer_slice;
+static QueueHandle_t xBuzzerFila;
+
+// Estado do sequenciador, só tocado pelo alarme enquanto buzzer_ativo
+static volatile bool buzzer_ativo = false; // Há uma cadeia de alarmes rodando
+static const buzzer_padrao_t *atual;
+static uint8_t nota;
+static bool soando;
+
+// Ajusta o PWM para 'freq_hz' com 50% de ciclo: o menor divisor inteiro
+// que deixa o período caber nos 16 bits do contador
+static void buzzer_frequencia(uint16_t freq_hz)
+{
+    uint32_t ciclos = clock_get_hz(clk_sys) / freq_hz;
+    uint32_t div = ciclos / 65536 + 1;
+    if (div > 255)
+    {
+        div = 255;
+    }
+    uint32_t wrap = ciclos / div - 1;
+    if (wrap > 65535)
+    {
+        wrap = 65535;
+    }
+    pwm_set_clkdiv_int_frac(buzzer_slice, div, 0);
+    pwm_set_wrap(buzzer_slice, wrap);
+    pwm_set_gpio_level(buzzer_pino, (wrap + 1) / 2);
+}
+
+// Callback do alarme: encerra a nota atual e começa a próxima. O retorno
+// negativo reagenda o alarme relativo ao alvo do disparo anterior (o
+// positivo contaria a partir do fim do callback), então o ritmo não acumula
+// atraso.
+static int64_t buzzer_passo(alarm_id_t id, void *user_data)
+{
+    if (soando)
+    {
+        pwm_set_enabled(buzzer_slice, false);
+        soando = false;
+        uint16_t pausa = atual->notas[nota++].pausa_ms;
+        if (pausa)
+        {
+            return -(int64_t)pausa * 1000;
+        }
+    }
+
+    if (atual == NULL || nota >= atual->n_notas)
+    {
+        // Próximo padrão. A checagem da fila e a marcação de ocioso são
+        // atômicas em relação a buzzer_tocar, então nenhum pedido fica preso.
+        UBaseType_t s = taskENTER_CRITICAL_FROM_ISR();
+        if (xQueueReceiveFromISR(xBuzzerFila, &atual, NULL) != pdTRUE)
+        {
+            atual = NULL;
+            buzzer_ativo = false;
+        }
+        taskEXIT_CRITICAL_FROM_ISR(s);
+        if (atual == NULL)
+        {
+            return 0; // Fim da cadeia
+        }
+        nota = 0;
+    }
+
+    const buzzer_nota_t *n = &atual->notas[nota];
+    if (n->freq_hz)
+    {
+        buzzer_frequencia(n->freq_hz);
+        pwm_set_enabled(buzzer_slice, true);
+    }
+    soando = true;
+    return -(int64_t)n->duracao_ms * 1000;
+}
+
+void buzzer_iniciar(uint pino)
+{
+    buzzer_pino = pino;
+    buzzer_slice = pwm_gpio_to_slice_num(pino);
+    gpio_set_function(pino, GPIO_FUNC_PWM);
+    pwm_config config = pwm_get_default_config();
+    pwm_init(buzzer_slice, &config, false);
+
+    CRIAR_FILA(xBuzzerFila, BUZZER_FILA, const buzzer_padrao_t *);
+    perfil_registrar_fila(xBuzzerFila, "buzzer");
+}
+
+bool buzzer_tocar(const buzzer_padrao_t *padrao)
+{
+    if (xQueueSend(xBuzzerFila, &padrao, 0) != pdTRUE)
+    {
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    bool iniciar = !buzzer_ativo;
+    buzzer_ativo = true;
+    taskEXIT_CRITICAL();
+
+    // Sem cadeia rodando: dispara o primeiro passo já
+    if (iniciar && add_alarm_in_us(1, buzzer_passo, NULL, true) < 0)
+    {
+        buzzer_ativo = false; // Sem alarme livre; o padrão toca no próximo pedido
+    }
+    return true;
+}
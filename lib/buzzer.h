@@ -0,0 +1,35 @@
+#ifndef BUZZER_H
+#define BUZZER_H
+
+#include "pico/stdlib.h"
+
+// Sequenciador do buzzer: toca padrões de notas sem bloquear quem pede.
+// Os padrões entram numa fila e um alarme de hardware encadeado avança nota
+// a nota, trocando a frequência do PWM (clkdiv/wrap) a cada uma.
+
+typedef struct
+{
+    uint16_t freq_hz;    // 0: silêncio pela duração da nota
+    uint16_t duracao_ms; // Tempo soando
+    uint16_t pausa_ms;   // Silêncio antes da próxima nota
+} buzzer_nota_t;
+
+typedef struct
+{
+    const buzzer_nota_t *notas;
+    uint8_t n_notas;
+} buzzer_padrao_t;
+
+// Alertas da aplicação, cada um com um timbre próprio
+extern const buzzer_padrao_t BUZZER_CAPACIDADE; // Entrada recusada: lotação máxima
+extern const buzzer_padrao_t BUZZER_NENHUM;     // Saída recusada: ninguém dentro
+extern const buzzer_padrao_t BUZZER_RESET;      // Sistema reiniciado
+
+// Configura o PWM do pino e cria a fila de padrões (antes do escalonador)
+void buzzer_iniciar(uint pino);
+
+// Enfileira um padrão e retorna na hora. Retorna false se a fila estiver
+// cheia (o alerta é descartado). Para uso em tarefas.
+bool buzzer_tocar(const buzzer_padrao_t *padrao);
+
+#endif /* BUZZER_H */
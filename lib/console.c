@@ -0,0 +1,86 @@
+#include "console.h"
+#include "estatico.h"
+#include <stdio.h>
+
+typedef struct
+{
+    char letra;
+    console_tratador_t tratador;
+} console_comando_t;
+
+static console_comando_t comandos[CONSOLE_MAX_COMANDOS];
+static uint8_t n_comandos;
+static TaskHandle_t tarefa_console;
+
+bool console_registrar(char letra, console_tratador_t tratador)
+{
+    if (n_comandos >= CONSOLE_MAX_COMANDOS)
+    {
+        return false;
+    }
+    comandos[n_comandos++] = (console_comando_t){letra, tratador};
+    return true;
+}
+
+static void executar(const char *linha)
+{
+    for (uint8_t i = 0; i < n_comandos; i++)
+    {
+        if (comandos[i].letra == linha[0])
+        {
+            const char *argumentos = linha + 1;
+            while (*argumentos == ' ')
+            {
+                argumentos++;
+            }
+            comandos[i].tratador(argumentos);
+            return;
+        }
+    }
+    printf("comando desconhecido: %s\n", linha);
+}
+
+/* Chamado pelo driver da stdio, em contexto de interrupção, quando chegam
+ * caracteres. A tarefa fica bloqueada até aqui em vez de consultar a
+ * entrada periodicamente, para não acordar o núcleo no modo ECONOMIA. */
+static void chegou_entrada(void *param)
+{
+    BaseType_t acordou = pdFALSE;
+    vTaskNotifyGiveFromISR(tarefa_console, &acordou);
+    portYIELD_FROM_ISR(acordou);
+}
+
+static void vTaskConsole(void *params)
+{
+    char linha[CONSOLE_LINHA + 1];
+    uint8_t n = 0;
+    while (true)
+    {
+        int c;
+        while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT)
+        {
+            if (c == '\r' || c == '\n')
+            {
+                linha[n] = '\0';
+                if (n > 0)
+                {
+                    executar(linha);
+                }
+                n = 0;
+            }
+            else if (n < CONSOLE_LINHA)
+            {
+                linha[n++] = (char)c;
+            }
+        }
+        // Um caractere que chegue depois da leitura deixa a notificação pendente
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+TaskHandle_t console_iniciar(UBaseType_t prioridade)
+{
+    CRIAR_TAREFA(vTaskConsole, "ConsoleTask", configMINIMAL_STACK_SIZE + 256, NULL, prioridade, &tarefa_console);
+    stdio_set_chars_available_callback(chegou_entrada, NULL);
+    return tarefa_console;
+}
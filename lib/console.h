@@ -0,0 +1,26 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Console de comandos na stdio (USB, ou UART com ECONOMIA). Uma única
+// tarefa, acordada pela interrupção da stdio quando chegam caracteres
+// (sem consultar a entrada periodicamente), lê a entrada e, a cada linha, chama o tratador registrado para a
+// primeira letra com o resto da linha (sem espaços iniciais). Assim o
+// rastreio ('h', 'z') e as credenciais ('e', 's') dividem a mesma entrada
+// sem disputar caracteres.
+
+#define CONSOLE_MAX_COMANDOS 8
+#define CONSOLE_LINHA 32 // Caracteres por linha; o excesso é descartado
+
+typedef void (*console_tratador_t)(const char *argumentos);
+
+// Registra antes de console_iniciar. Retorna false se não houver vaga.
+bool console_registrar(char letra, console_tratador_t tratador);
+
+// Cria a tarefa do console e retorna o seu handle
+TaskHandle_t console_iniciar(UBaseType_t prioridade);
+
+#endif /* CONSOLE_H */
@@ -0,0 +1,23 @@
+#include "crc32.h"
+
+// Tabela de 16 entradas (4 bits por passo): 64 bytes de flash em vez dos
+// 1 KB da tabela completa; o volume de dados do diário é pequeno.
+static const uint32_t CRC32_TABELA[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+    0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+uint32_t crc32_atualizar(uint32_t crc, const void *dados, size_t n)
+{
+    const uint8_t *p = dados;
+    crc = ~crc;
+    while (n--)
+    {
+        crc ^= *p++;
+        crc = CRC32_TABELA[crc & 0x0F] ^ (crc >> 4);
+        crc = CRC32_TABELA[crc & 0x0F] ^ (crc >> 4);
+    }
+    return ~crc;
+}
@@ -0,0 +1,16 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// CRC-32 (IEEE 802.3, o mesmo do zlib). Encadeável: passe o resultado de
+// uma chamada como 'crc' da seguinte; comece com 0.
+uint32_t crc32_atualizar(uint32_t crc, const void *dados, size_t n);
+
+static inline uint32_t crc32(const void *dados, size_t n)
+{
+    return crc32_atualizar(0, dados, n);
+}
+
+#endif /* CRC32_H */
@@ -0,0 +1,108 @@
+#include "credencial.h"
+#include <string.h>
+
+void credencial_iniciar(credencial_t *credencial, const credencial_tabela_t *tabela, uint32_t *presentes,
+                        ocupacao_t *ocupacao)
+{
+    credencial->tabela = tabela;
+    credencial->presentes = presentes;
+    credencial->ocupacao = ocupacao;
+    credencial->lock = spin_lock_init(spin_lock_claim_unused(true));
+    memset(presentes, 0, (tabela->n + 31) / 32 * sizeof(uint32_t));
+}
+
+int32_t credencial_buscar(const credencial_tabela_t *tabela, uint32_t id)
+{
+    uint32_t chave = credencial_chave(id);
+    uint32_t balde = tabela->bits_balde ? chave >> (32 - tabela->bits_balde) : 0;
+    uint32_t ini = tabela->baldes[balde];
+    uint32_t fim = tabela->baldes[balde + 1];
+
+    // Busca binária no balde: no máximo log2(maior_balde) + 1 comparações
+    while (ini < fim)
+    {
+        uint32_t meio = ini + (fim - ini) / 2;
+        uint32_t c = tabela->chaves[meio];
+        if (c == chave)
+        {
+            return (int32_t)meio;
+        }
+        if (c < chave)
+        {
+            ini = meio + 1;
+        }
+        else
+        {
+            fim = meio;
+        }
+    }
+    return -1;
+}
+
+static inline bool presente(const credencial_t *credencial, uint32_t i)
+{
+    return credencial->presentes[i / 32] & (1u << (i % 32));
+}
+
+// Só o bitmap e a ocupação mudam com o spinlock; a busca na flash já foi
+// feita por quem chama
+credencial_resultado_t credencial_entrar(credencial_t *credencial, int32_t i, uint16_t *resultante)
+{
+    if (i < 0)
+    {
+        *resultante = ocupacao_ler(credencial->ocupacao);
+        return CREDENCIAL_DESCONHECIDA;
+    }
+
+    credencial_resultado_t r;
+    uint32_t irq = spin_lock_blocking(credencial->lock);
+    if (presente(credencial, i))
+    {
+        r = CREDENCIAL_PRESENCA;
+        *resultante = ocupacao_ler(credencial->ocupacao);
+    }
+    else if (ocupacao_entrar(credencial->ocupacao, resultante))
+    {
+        r = CREDENCIAL_ACEITA;
+        credencial->presentes[i / 32] |= 1u << (i % 32);
+    }
+    else
+    {
+        r = CREDENCIAL_OCUPACAO;
+    }
+    spin_unlock(credencial->lock, irq);
+    return r;
+}
+
+credencial_resultado_t credencial_sair(credencial_t *credencial, int32_t i, uint16_t *resultante)
+{
+    if (i < 0)
+    {
+        *resultante = ocupacao_ler(credencial->ocupacao);
+        return CREDENCIAL_DESCONHECIDA;
+    }
+
+    credencial_resultado_t r = CREDENCIAL_PRESENCA;
+    uint32_t irq = spin_lock_blocking(credencial->lock);
+    if (presente(credencial, i) && ocupacao_sair(credencial->ocupacao, resultante))
+    {
+        r = CREDENCIAL_ACEITA;
+        credencial->presentes[i / 32] &= ~(1u << (i % 32));
+    }
+    else
+    {
+        *resultante = ocupacao_ler(credencial->ocupacao);
+    }
+    spin_unlock(credencial->lock, irq);
+    return r;
+}
+
+// Limpa o bitmap inteiro com as interrupções desligadas: N/32 palavras,
+// dezenas de µs para 100 mil credenciais (só no reset)
+void credencial_zerar(credencial_t *credencial)
+{
+    uint32_t irq = spin_lock_blocking(credencial->lock);
+    memset(credencial->presentes, 0, (credencial->tabela->n + 31) / 32 * sizeof(uint32_t));
+    ocupacao_zerar(credencial->ocupacao);
+    spin_unlock(credencial->lock, irq);
+}
@@ -0,0 +1,80 @@
+#ifndef CREDENCIAL_H
+#define CREDENCIAL_H
+
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "ocupacao.h"
+
+// Credenciais autorizadas e quem está dentro (cmake -DCREDENCIAIS=ON).
+//
+// A lista de IDs autorizados vira, no build, uma tabela em flash gerada por
+// tools/gerar_credenciais.py: as chaves são os IDs embaralhados por
+// credencial_chave (uma bijeção, então a chave identifica o ID), em ordem
+// crescente, e um índice de baldes pelos bits altos da chave aponta o
+// trecho de cada balde. Uma busca é um balde direto mais uma busca binária
+// nele; o gerador grava o maior balde, então o número de comparações do
+// pior caso é conhecido no build.
+//
+// A posição da chave na tabela é o número da credencial, e o conjunto de
+// presentes é um bitmap em RAM com um bit por credencial. Bitmap e
+// ocupação mudam juntos sob um spinlock de hardware, então as funções de
+// entrada, saída e zerar podem ser chamadas de tarefas e da ISR.
+
+typedef struct
+{
+    const uint32_t *chaves; // credencial_chave(id), em ordem crescente
+    const uint32_t *baldes; // Balde b: chaves[baldes[b]] até chaves[baldes[b + 1] - 1]
+    uint32_t n;             // Credenciais na tabela
+    uint8_t bits_balde;     // 2^bits_balde baldes (bits altos da chave)
+    uint16_t maior_balde;   // Chaves no balde mais cheio
+} credencial_tabela_t;
+
+// Gerados por tools/gerar_credenciais.py
+extern const credencial_tabela_t CREDENCIAIS_AUTORIZADAS;
+extern uint32_t credenciais_presentes[]; // (n + 31) / 32 palavras
+
+typedef struct
+{
+    const credencial_tabela_t *tabela;
+    uint32_t *presentes;
+    ocupacao_t *ocupacao;
+    spin_lock_t *lock;
+} credencial_t;
+
+typedef enum
+{
+    CREDENCIAL_ACEITA,
+    CREDENCIAL_DESCONHECIDA, // Fora da lista de autorizadas
+    CREDENCIAL_PRESENCA,     // Já está dentro (entrada) ou não está (saída)
+    CREDENCIAL_OCUPACAO      // Sem vaga (entrada)
+} credencial_resultado_t;
+
+// Finalizador do MurmurHash3: bijeção de 32 bits que espalha IDs
+// sequenciais pelos baldes. Deve ser igual à do gerador.
+static inline uint32_t credencial_chave(uint32_t id)
+{
+    id ^= id >> 16;
+    id *= 0x85ebca6bu;
+    id ^= id >> 13;
+    id *= 0xc2b2ae35u;
+    id ^= id >> 16;
+    return id;
+}
+
+void credencial_iniciar(credencial_t *credencial, const credencial_tabela_t *tabela, uint32_t *presentes,
+                        ocupacao_t *ocupacao);
+
+// Número da credencial (0..n-1) ou -1 se o ID não está autorizado
+int32_t credencial_buscar(const credencial_tabela_t *tabela, uint32_t id);
+
+// Entrada e saída da credencial 'indice', o retorno de credencial_buscar
+// (-1: desconhecida). A busca fica com quem chama, fora de qualquer seção
+// crítica, porque lê a tabela na flash. Em 'resultante' fica a ocupação
+// após a decisão.
+credencial_resultado_t credencial_entrar(credencial_t *credencial, int32_t indice, uint16_t *resultante);
+credencial_resultado_t credencial_sair(credencial_t *credencial, int32_t indice, uint16_t *resultante);
+
+// Esvazia o conjunto de presentes e zera a ocupação (reset)
+void credencial_zerar(credencial_t *credencial);
+
+#endif /* CREDENCIAL_H */
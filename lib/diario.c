@@ -0,0 +1,163 @@
+#include "diario.h"
+#include "crc32.h"
+#include <string.h>
+
+#define PAGINAS_SETOR (FLASH_OPS_SETOR / FLASH_OPS_PAGINA)
+
+static uint32_t crc_pagina(const diario_pagina_t *pagina)
+{
+    uint32_t crc = crc32(&pagina->cab, offsetof(diario_cabecalho_t, crc));
+    return crc32_atualizar(crc, pagina->eventos, pagina->cab.n * sizeof(diario_evento_t));
+}
+
+// Lê a página 'indice' e diz se ela tem um registro íntegro
+static bool ler_pagina(const diario_t *diario, uint32_t indice, diario_pagina_t *pagina)
+{
+    if (!diario->ops->ler(diario->ops, indice * FLASH_OPS_PAGINA, pagina, FLASH_OPS_PAGINA))
+    {
+        return false;
+    }
+    return pagina->cab.magico == DIARIO_MAGICO && pagina->cab.n >= 1 &&
+           pagina->cab.n <= DIARIO_EVENTOS_PAGINA && pagina->cab.crc == crc_pagina(pagina);
+}
+
+static bool em_branco(const diario_pagina_t *pagina)
+{
+    const uint8_t *p = (const uint8_t *)pagina;
+    for (uint32_t i = 0; i < FLASH_OPS_PAGINA; i++)
+    {
+        if (p[i] != 0xFF)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool diario_abrir(diario_t *diario, const flash_ops_t *ops)
+{
+    diario_pagina_t pagina;
+
+    diario->ops = ops;
+    diario->n_paginas = ops->tamanho / FLASH_OPS_PAGINA;
+    diario->proxima = 0;
+    diario->seq = 1;
+    diario->erros = 0;
+    diario->apagado = 0;
+    if (ops->tamanho < 2 * FLASH_OPS_SETOR)
+    {
+        return false; // Precisa de um setor para apagar enquanto o outro guarda dados
+    }
+
+    for (uint32_t i = 0; i < diario->n_paginas; i++)
+    {
+        if (ler_pagina(diario, i, &pagina) && pagina.cab.seq >= diario->seq)
+        {
+            diario->seq = pagina.cab.seq + 1;
+            diario->proxima = (i + 1) % diario->n_paginas;
+        }
+    }
+    return true;
+}
+
+bool diario_gravar(diario_t *diario, const diario_evento_t *eventos, uint16_t n, uint16_t perdidos)
+{
+    diario_pagina_t pagina, conferida;
+    const flash_ops_t *ops = diario->ops;
+
+    if (n == 0 || n > DIARIO_EVENTOS_PAGINA)
+    {
+        return false;
+    }
+    memset(&pagina, 0xFF, sizeof(pagina));
+    pagina.cab.magico = DIARIO_MAGICO;
+    pagina.cab.seq = diario->seq;
+    pagina.cab.n = n;
+    pagina.cab.perdidos = perdidos;
+    memcpy(pagina.eventos, eventos, n * sizeof(diario_evento_t));
+    pagina.cab.crc = crc_pagina(&pagina);
+
+    // No máximo uma volta pela região procurando uma página que aceite
+    for (uint32_t tentativa = 0; tentativa < diario->n_paginas; tentativa++)
+    {
+        uint32_t indice = diario->proxima;
+        uint32_t offset = indice * FLASH_OPS_PAGINA;
+        diario->proxima = (indice + 1) % diario->n_paginas;
+
+        if (indice % PAGINAS_SETOR == 0 && diario->apagado == indice / PAGINAS_SETOR + 1)
+        {
+            diario->apagado = 0; // Apagado por diario_preparar
+        }
+        else if (indice % PAGINAS_SETOR == 0)
+        {
+            // Início de setor: descarta as páginas mais antigas
+            if (!ops->apagar(ops, offset))
+            {
+                diario->erros++;
+                continue;
+            }
+        }
+        else if (!ops->ler(ops, offset, &conferida, FLASH_OPS_PAGINA) || !em_branco(&conferida))
+        {
+            continue; // Gravação interrompida antes de um reset: pula
+        }
+
+        if (ops->programar(ops, offset, &pagina) &&
+            ops->ler(ops, offset, &conferida, FLASH_OPS_PAGINA) &&
+            memcmp(&pagina, &conferida, FLASH_OPS_PAGINA) == 0)
+        {
+            diario->seq++;
+            return true;
+        }
+        diario->erros++;
+    }
+    return false;
+}
+
+bool diario_preparar(diario_t *diario)
+{
+    // O setor da próxima página se ela abre um setor; senão, o seguinte
+    uint32_t n_setores = diario->n_paginas / PAGINAS_SETOR;
+    uint32_t setor = diario->proxima / PAGINAS_SETOR;
+    if (diario->proxima % PAGINAS_SETOR != 0)
+    {
+        setor = (setor + 1) % n_setores;
+    }
+    if (diario->apagado == setor + 1)
+    {
+        return true;
+    }
+    if (!diario->ops->apagar(diario->ops, setor * FLASH_OPS_SETOR))
+    {
+        diario->erros++;
+        return false;
+    }
+    diario->apagado = setor + 1;
+    return true;
+}
+
+uint32_t diario_percorrer(const diario_t *diario, diario_visitante_t visitar, void *ctx)
+{
+    diario_pagina_t pagina;
+    uint32_t visitados = 0;
+
+    // Da página seguinte à mais recente dá-se uma volta completa: primeiro
+    // vêm as mais antigas
+    for (uint32_t k = 0; k < diario->n_paginas; k++)
+    {
+        uint32_t indice = (diario->proxima + k) % diario->n_paginas;
+        if (!ler_pagina(diario, indice, &pagina))
+        {
+            continue;
+        }
+        for (uint16_t e = 0; e < pagina.cab.n; e++)
+        {
+            visitados++;
+            if (!visitar(&pagina.eventos[e], pagina.cab.seq, ctx))
+            {
+                return visitados;
+            }
+        }
+    }
+    return visitados;
+}
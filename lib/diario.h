@@ -0,0 +1,152 @@
+#ifndef DIARIO_H
+#define DIARIO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "flash_ops.h"
+
+// Diário de eventos (entradas, saídas, recusas e resets).
+//
+// Caminho dos eventos: a ISR dos botões grava cada evento num anel em RAM
+// sem travas (um produtor, um consumidor) e volta. Uma tarefa de baixa
+// prioridade esvazia o anel e grava os eventos em flash, uma página de
+// 256 bytes por vez. Apagar e gravar a flash desligam as interrupções (ver
+// flash_rp2040.c), então durante essas pausas a ISR não roda: bordas
+// repetidas no mesmo pino viram uma só e se perdem. Gravar uma página custa
+// ~1 ms; apagar um setor, dezenas de ms, e por isso é feito com antecedência
+// (diario_preparar) quando não há eventos chegando.
+//
+// Formato em flash: a região é um log circular de páginas. Cada página tem
+// um cabeçalho {magico, seq, n, perdidos, crc} seguido de até
+// DIARIO_EVENTOS_PAGINA eventos. As páginas são gravadas em sequência e o
+// setor seguinte só é apagado quando a escrita chega nele, então o desgaste
+// se espalha igualmente por toda a região; com diario_preparar o setor
+// seguinte é apagado antes, e o log guarda um setor a menos de histórico.
+// Na partida, a página válida de maior seq indica onde continuar.
+//
+// O núcleo não depende do FreeRTOS nem do SDK e roda no PC sobre
+// flash_ops_arquivo.
+
+typedef enum
+{
+    DIARIO_ENTRADA,
+    DIARIO_SAIDA,
+    DIARIO_RECUSA_ENTRADA, // Lotação máxima
+    DIARIO_RECUSA_SAIDA,   // Ninguém dentro
+    DIARIO_RESET           // 'usuarios' = ocupação antes de zerar
+} diario_tipo_t;
+
+typedef struct
+{
+    uint32_t tempo_ms; // Desde a partida
+    uint8_t tipo;      // diario_tipo_t
+    uint8_t reservado;
+    uint16_t usuarios; // Ocupação após o evento
+} diario_evento_t;
+
+typedef struct
+{
+    uint32_t magico;
+    uint32_t seq;       // Crescente, nunca se repete
+    uint16_t n;         // Eventos na página
+    uint16_t perdidos;  // Eventos descartados com o anel cheio antes desta página
+    uint32_t crc;       // CRC-32 do cabeçalho (até 'perdidos') e dos n eventos
+} diario_cabecalho_t;
+
+#define DIARIO_MAGICO 0x44494152u // "DIAR"
+#define DIARIO_EVENTOS_PAGINA ((FLASH_OPS_PAGINA - sizeof(diario_cabecalho_t)) / sizeof(diario_evento_t))
+
+typedef struct
+{
+    diario_cabecalho_t cab;
+    diario_evento_t eventos[DIARIO_EVENTOS_PAGINA];
+} diario_pagina_t;
+
+_Static_assert(sizeof(diario_pagina_t) == FLASH_OPS_PAGINA, "página do diário deve ocupar uma página de flash");
+
+typedef struct
+{
+    const flash_ops_t *ops;
+    uint32_t n_paginas;
+    uint32_t proxima; // Página a gravar em seguida
+    uint32_t seq;     // seq da próxima página
+    uint32_t erros;   // Páginas que falharam ao gravar ou conferir
+    uint32_t apagado; // Setor já apagado por diario_preparar, mais 1 (0: nenhum)
+} diario_t;
+
+// Varre a região e posiciona a escrita após a página mais recente.
+// Retorna false se a região não tiver ao menos dois setores.
+bool diario_abrir(diario_t *diario, const flash_ops_t *ops);
+
+// Grava uma página com 'n' eventos (1 a DIARIO_EVENTOS_PAGINA). Apaga o
+// setor ao entrar nele, pula páginas não apagadas e confere a gravação
+// relendo; retorna false se nenhuma página da região aceitou os dados.
+bool diario_gravar(diario_t *diario, const diario_evento_t *eventos, uint16_t n, uint16_t perdidos);
+
+// Apaga com antecedência o próximo setor em que a escrita vai entrar, para
+// que diario_gravar não precise apagar. Chamar num momento em que perder
+// uma borda de botão é aceitável (sem eventos recentes). Retorna false se
+// o apagamento falhar.
+bool diario_preparar(diario_t *diario);
+
+// Chama 'visitar' para cada evento gravado, do mais antigo ao mais novo,
+// até ela retornar false. Retorna o número de eventos visitados.
+typedef bool (*diario_visitante_t)(const diario_evento_t *evento, uint32_t seq, void *ctx);
+uint32_t diario_percorrer(const diario_t *diario, diario_visitante_t visitar, void *ctx);
+
+// ---------------------------------------------------------------------------
+// Anel em RAM entre a ISR (produtor) e a tarefa do diário (consumidor).
+// Cada índice só é escrito por um lado; as barreiras garantem que o evento
+// esteja na memória antes do índice que o publica.
+// ---------------------------------------------------------------------------
+
+#define DIARIO_ANEL 64 // Potência de 2
+
+typedef struct
+{
+    diario_evento_t eventos[DIARIO_ANEL];
+    volatile uint32_t cabeca;   // Escrito só pelo produtor
+    volatile uint32_t cauda;    // Escrito só pelo consumidor
+    volatile uint32_t perdidos; // Eventos descartados com o anel cheio
+} diario_anel_t;
+
+static inline uint32_t diario_anel_ocupado(const diario_anel_t *anel)
+{
+    return anel->cabeca - anel->cauda;
+}
+
+// Produtor: retorna false (e conta a perda) se o anel estiver cheio
+static inline bool diario_anel_por(diario_anel_t *anel, const diario_evento_t *evento)
+{
+    uint32_t cabeca = anel->cabeca;
+    if (cabeca - anel->cauda >= DIARIO_ANEL)
+    {
+        anel->perdidos++;
+        return false;
+    }
+    anel->eventos[cabeca & (DIARIO_ANEL - 1)] = *evento;
+    __sync_synchronize();
+    anel->cabeca = cabeca + 1;
+    return true;
+}
+
+// Consumidor: copia até 'max' eventos para 'destino' e os libera
+static inline uint32_t diario_anel_tirar(diario_anel_t *anel, diario_evento_t *destino, uint32_t max)
+{
+    uint32_t cauda = anel->cauda;
+    uint32_t n = anel->cabeca - cauda;
+    if (n > max)
+    {
+        n = max;
+    }
+    __sync_synchronize();
+    for (uint32_t i = 0; i < n; i++)
+    {
+        destino[i] = anel->eventos[(cauda + i) & (DIARIO_ANEL - 1)];
+    }
+    __sync_synchronize();
+    anel->cauda = cauda + n;
+    return n;
+}
+
+#endif /* DIARIO_H */
@@ -0,0 +1,40 @@
+#include "estatico.h"
+
+// Sem heap, o kernel pede ao programa a memória das tarefas que ele mesmo
+// cria: a ociosa (uma por núcleo) e a dos temporizadores.
+
+#if configSUPPORT_STATIC_ALLOCATION
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **tcb, StackType_t **pilha, uint32_t *profundidade)
+{
+    static StaticTask_t tcbOcioso;
+    static StackType_t pilhaOcioso[configMINIMAL_STACK_SIZE];
+    *tcb = &tcbOcioso;
+    *pilha = pilhaOcioso;
+    *profundidade = configMINIMAL_STACK_SIZE;
+}
+
+#if defined(configNUMBER_OF_CORES) && configNUMBER_OF_CORES > 1
+void vApplicationGetPassiveIdleTaskMemory(StaticTask_t **tcb, StackType_t **pilha, uint32_t *profundidade,
+                                          BaseType_t indice)
+{
+    static StaticTask_t tcbPassivo[configNUMBER_OF_CORES - 1];
+    static StackType_t pilhaPassivo[configNUMBER_OF_CORES - 1][configMINIMAL_STACK_SIZE];
+    *tcb = &tcbPassivo[indice];
+    *pilha = pilhaPassivo[indice];
+    *profundidade = configMINIMAL_STACK_SIZE;
+}
+#endif
+
+#if configUSE_TIMERS
+void vApplicationGetTimerTaskMemory(StaticTask_t **tcb, StackType_t **pilha, uint32_t *profundidade)
+{
+    static StaticTask_t tcbTemporizador;
+    static StackType_t pilhaTemporizador[configTIMER_TASK_STACK_DEPTH];
+    *tcb = &tcbTemporizador;
+    *pilha = pilhaTemporizador;
+    *profundidade = configTIMER_TASK_STACK_DEPTH;
+}
+#endif
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
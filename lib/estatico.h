@@ -0,0 +1,61 @@
+#ifndef ESTATICO_H
+#define ESTATICO_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+// Criação de tarefas, filas e semáforos com a memória decidida na
+// compilação. Com -DESTATICO=ON (configSUPPORT_STATIC_ALLOCATION sem heap)
+// cada expansão reserva o TCB e a pilha, ou a área da fila, em variáveis
+// estáticas próprias, que entram no .bss do módulo que a chamou e aparecem
+// no relatório de memória; sem a opção, tudo vem do heap_4.
+//
+// Como a memória é da expansão, cada ponto de chamada só pode criar um
+// objeto: não use estes macros em laços nem em funções chamadas mais de
+// uma vez. 'profundidade' e 'n' precisam ser constantes.
+
+#if configSUPPORT_STATIC_ALLOCATION && !configSUPPORT_DYNAMIC_ALLOCATION
+
+#define CRIAR_TAREFA(funcao, nome, profundidade, parametro, prioridade, tarefa)                      \
+    do                                                                                               \
+    {                                                                                                \
+        static StackType_t pilha_[profundidade];                                                     \
+        static StaticTask_t tcb_;                                                                    \
+        TaskHandle_t *destino_ = (tarefa);                                                           \
+        TaskHandle_t criada_ =                                                                       \
+            xTaskCreateStatic(funcao, nome, profundidade, parametro, prioridade, pilha_, &tcb_);     \
+        if (destino_)                                                                                \
+        {                                                                                            \
+            *destino_ = criada_;                                                                     \
+        }                                                                                            \
+    } while (0)
+
+#define CRIAR_FILA(fila, n, tipo)                                                                    \
+    do                                                                                               \
+    {                                                                                                \
+        static uint8_t area_[(n) * sizeof(tipo)];                                                    \
+        static StaticQueue_t controle_;                                                              \
+        (fila) = xQueueCreateStatic(n, sizeof(tipo), area_, &controle_);                             \
+    } while (0)
+
+#define CRIAR_SEMAFORO_BINARIO(semaforo)                                                             \
+    do                                                                                               \
+    {                                                                                                \
+        static StaticSemaphore_t controle_;                                                          \
+        (semaforo) = xSemaphoreCreateBinaryStatic(&controle_);                                       \
+    } while (0)
+
+#else
+
+#define CRIAR_TAREFA(funcao, nome, profundidade, parametro, prioridade, tarefa)                      \
+    xTaskCreate(funcao, nome, profundidade, parametro, prioridade, tarefa)
+
+#define CRIAR_FILA(fila, n, tipo) ((fila) = xQueueCreate(n, sizeof(tipo)))
+
+#define CRIAR_SEMAFORO_BINARIO(semaforo) ((semaforo) = xSemaphoreCreateBinary())
+
+#endif
+
+#endif /* ESTATICO_H */
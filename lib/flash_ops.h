@@ -0,0 +1,42 @@
+#ifndef FLASH_OPS_H
+#define FLASH_OPS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Acesso a uma região de flash NOR, independente do meio. Offsets são
+// relativos ao início da região. Semântica de NOR: apagar deixa o setor
+// todo em 0xFF e gravar só leva bits de 1 para 0. Cada função retorna
+// false em erro (offset fora da região ou desalinhado, falha de E/S).
+//
+// Backends: flash_ops_rp2040 (flash do próprio RP2040, flash_rp2040.c) e
+// flash_ops_arquivo (arquivo no PC, host/flash_arquivo.c), que permite
+// exercitar o formato do diário fora da placa.
+
+#define FLASH_OPS_SETOR 4096  // Menor unidade de apagamento
+#define FLASH_OPS_PAGINA 256  // Unidade de gravação
+
+typedef struct flash_ops flash_ops_t;
+struct flash_ops
+{
+    bool (*ler)(const flash_ops_t *ops, uint32_t offset, void *destino, uint32_t n);
+    bool (*apagar)(const flash_ops_t *ops, uint32_t offset);                      // Um setor
+    bool (*programar)(const flash_ops_t *ops, uint32_t offset, const void *origem); // Uma página
+    void *ctx;        // Dados do backend
+    uint32_t tamanho; // Bytes da região, múltiplo de FLASH_OPS_SETOR
+};
+
+// Confere alinhamento e limites de um acesso de 'n' bytes
+static inline bool flash_ops_valido(const flash_ops_t *ops, uint32_t offset, uint32_t n, uint32_t alinhamento)
+{
+    return (offset % alinhamento) == 0 && offset + n <= ops->tamanho && offset + n >= offset;
+}
+
+// Região de 'tamanho' bytes começando em 'offset' bytes do início da flash
+void flash_ops_rp2040(flash_ops_t *ops, uint32_t offset, uint32_t tamanho);
+
+// µs acumulados com as interrupções desligadas em apagar/programar de
+// flash_ops_rp2040 (na simulação, sempre 0)
+extern volatile uint32_t flash_ops_bloqueio_us;
+
+#endif /* FLASH_OPS_H */
@@ -0,0 +1,89 @@
+#include "flash_ops.h"
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include <string.h>
+
+// Backend de flash_ops_t sobre a flash QSPI do RP2040; ctx guarda o início
+// da região. Durante apagamento e gravação a flash sai do modo XIP, então
+// nada pode executar dela. flash_safe_execute desliga as interrupções neste
+// núcleo e, no build de dois núcleos, segura o outro numa rotina em RAM
+// enquanto a operação roda.
+//
+// Só a tarefa do diário chama estas funções, mas a pausa atinge o sistema
+// todo: enquanto ela dura, a ISR dos botões não roda e várias bordas no
+// mesmo pino viram uma só. Gravar uma página leva ~1 ms; apagar um setor,
+// dezenas a centenas de ms, e por isso o diário apaga com antecedência
+// quando não há eventos (diario_preparar). O tempo total com as interrupções
+// desligadas fica em flash_ops_bloqueio_us.
+
+#define REGIAO(ops) ((uint32_t)(uintptr_t)(ops)->ctx)
+#define FLASH_SEGURO_MS 100 // Prazo para o outro núcleo parar (e voltar)
+
+volatile uint32_t flash_ops_bloqueio_us;
+
+typedef struct
+{
+    uint32_t offset; // Desde o início da flash
+    const void *origem;
+} flash_pedido_t;
+
+static void apagar_seguro(void *param)
+{
+    const flash_pedido_t *p = param;
+    flash_range_erase(p->offset, FLASH_SECTOR_SIZE);
+}
+
+static void programar_seguro(void *param)
+{
+    const flash_pedido_t *p = param;
+    flash_range_program(p->offset, p->origem, FLASH_PAGE_SIZE);
+}
+
+// Executa a operação com a flash fora do XIP e soma a pausa
+static bool executar(void (*operacao)(void *), flash_pedido_t *p)
+{
+    uint32_t inicio = time_us_32();
+    int r = flash_safe_execute(operacao, p, FLASH_SEGURO_MS);
+    flash_ops_bloqueio_us += time_us_32() - inicio;
+    return r == PICO_OK;
+}
+
+static bool rp2040_ler(const flash_ops_t *ops, uint32_t offset, void *destino, uint32_t n)
+{
+    if (!flash_ops_valido(ops, offset, n, 1))
+    {
+        return false;
+    }
+    memcpy(destino, (const void *)(uintptr_t)(XIP_BASE + REGIAO(ops) + offset), n);
+    return true;
+}
+
+static bool rp2040_apagar(const flash_ops_t *ops, uint32_t offset)
+{
+    if (!flash_ops_valido(ops, offset, FLASH_OPS_SETOR, FLASH_OPS_SETOR))
+    {
+        return false;
+    }
+    flash_pedido_t p = {REGIAO(ops) + offset, NULL};
+    return executar(apagar_seguro, &p);
+}
+
+static bool rp2040_programar(const flash_ops_t *ops, uint32_t offset, const void *origem)
+{
+    if (!flash_ops_valido(ops, offset, FLASH_OPS_PAGINA, FLASH_OPS_PAGINA))
+    {
+        return false;
+    }
+    flash_pedido_t p = {REGIAO(ops) + offset, origem};
+    return executar(programar_seguro, &p);
+}
+
+void flash_ops_rp2040(flash_ops_t *ops, uint32_t offset, uint32_t tamanho)
+{
+    ops->ler = rp2040_ler;
+    ops->apagar = rp2040_apagar;
+    ops->programar = rp2040_programar;
+    ops->ctx = (void *)(uintptr_t)offset;
+    ops->tamanho = tamanho;
+}
@@ -0,0 +1,158 @@
+#include "instantaneo.h"
+#include "crc32.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+#define INSTANTANEO_MAGICO 0x494E5354u // "INST"
+#define INSTANTANEO_RECUOS 4
+#define REGISTROS_SETOR (FLASH_OPS_SETOR / sizeof(instantaneo_t))
+
+// Cópia em RAM: fora da seção .bss, não é zerada na partida
+static instantaneo_t __uninitialized_ram(instantaneo_ram);
+
+static const flash_ops_t *ops_flash;
+static uint32_t proximo;       // Registro da flash a gravar em seguida
+static uint32_t seq_gravado;   // seq do último registro na flash
+static uint32_t n_registros;
+
+static uint32_t crc_instantaneo(const instantaneo_t *inst)
+{
+    return crc32(inst, offsetof(instantaneo_t, crc));
+}
+
+static bool integro(const instantaneo_t *inst)
+{
+    return inst->magico == INSTANTANEO_MAGICO && inst->crc == crc_instantaneo(inst);
+}
+
+static bool ler_registro(uint32_t indice, instantaneo_t *inst)
+{
+    return ops_flash->ler(ops_flash, indice * sizeof(instantaneo_t), inst, sizeof(instantaneo_t));
+}
+
+static bool em_branco(const instantaneo_t *inst)
+{
+    const uint32_t *p = (const uint32_t *)inst;
+    for (uint32_t i = 0; i < sizeof(instantaneo_t) / 4; i++)
+    {
+        if (p[i] != 0xFFFFFFFFu)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Primeiro registro em branco do setor (REGISTROS_SETOR se cheio). Os
+// registros são anexados em ordem, então os usados formam um prefixo.
+static uint32_t primeiro_em_branco(uint32_t setor)
+{
+    uint32_t base = setor * REGISTROS_SETOR;
+    uint32_t ini = 0, fim = REGISTROS_SETOR;
+    instantaneo_t inst;
+    while (ini < fim)
+    {
+        uint32_t meio = (ini + fim) / 2;
+        if (ler_registro(base + meio, &inst) && em_branco(&inst))
+        {
+            fim = meio;
+        }
+        else
+        {
+            ini = meio + 1;
+        }
+    }
+    return ini;
+}
+
+instantaneo_origem_t instantaneo_restaurar(const flash_ops_t *ops, uint16_t *usuarios)
+{
+    instantaneo_t melhor, inst;
+    instantaneo_origem_t origem = INSTANTANEO_NENHUM;
+
+    ops_flash = ops;
+    n_registros = ops->tamanho / sizeof(instantaneo_t);
+    proximo = 0;
+    seq_gravado = 0;
+    memset(&melhor, 0, sizeof(melhor));
+
+    // Último registro íntegro de cada setor da flash
+    for (uint32_t setor = 0; setor < ops->tamanho / FLASH_OPS_SETOR; setor++)
+    {
+        uint32_t livre = primeiro_em_branco(setor);
+        for (uint32_t k = 1; k <= INSTANTANEO_RECUOS && k <= livre; k++)
+        {
+            if (ler_registro(setor * REGISTROS_SETOR + livre - k, &inst) && integro(&inst))
+            {
+                if (origem == INSTANTANEO_NENHUM || inst.seq > melhor.seq)
+                {
+                    melhor = inst;
+                    origem = INSTANTANEO_FLASH;
+                    seq_gravado = inst.seq;
+                    proximo = (setor * REGISTROS_SETOR + livre) % n_registros;
+                }
+                break;
+            }
+        }
+    }
+
+    // A cópia em RAM vence se for íntegra e mais nova
+    if (integro(&instantaneo_ram) && (origem == INSTANTANEO_NENHUM || instantaneo_ram.seq > melhor.seq))
+    {
+        melhor = instantaneo_ram;
+        origem = INSTANTANEO_RAM;
+    }
+
+    *usuarios = origem == INSTANTANEO_NENHUM ? 0 : melhor.usuarios;
+
+    // Recomeça a cópia em RAM a partir do estado restaurado
+    instantaneo_ram.magico = INSTANTANEO_MAGICO;
+    instantaneo_ram.seq = melhor.seq;
+    instantaneo_ram.usuarios = *usuarios;
+    instantaneo_ram.reservado = 0;
+    instantaneo_ram.crc = crc_instantaneo(&instantaneo_ram);
+    return origem;
+}
+
+void instantaneo_atualizar(uint16_t usuarios)
+{
+    instantaneo_ram.seq++;
+    instantaneo_ram.usuarios = usuarios;
+    instantaneo_ram.crc = crc_instantaneo(&instantaneo_ram);
+}
+
+bool instantaneo_gravar_flash(void)
+{
+    instantaneo_t inst;
+    uint8_t pagina[FLASH_OPS_PAGINA];
+
+    // Cópia consistente: a ISR pode atualizar a RAM a qualquer momento
+    uint32_t irq = save_and_disable_interrupts();
+    inst = instantaneo_ram;
+    restore_interrupts(irq);
+
+    if (ops_flash == NULL || inst.seq == seq_gravado || !integro(&inst))
+    {
+        return false;
+    }
+
+    uint32_t offset = proximo * sizeof(instantaneo_t);
+    if (proximo % REGISTROS_SETOR == 0 && !ops_flash->apagar(ops_flash, offset))
+    {
+        return false;
+    }
+
+    // Grava a página com 0xFF fora do registro: na NOR isso preserva os
+    // registros já gravados nela
+    uint32_t pos = offset % FLASH_OPS_PAGINA;
+    memset(pagina, 0xFF, sizeof(pagina));
+    memcpy(&pagina[pos], &inst, sizeof(inst));
+    if (!ops_flash->programar(ops_flash, offset - pos, pagina))
+    {
+        return false;
+    }
+
+    proximo = (proximo + 1) % n_registros;
+    seq_gravado = inst.seq;
+    return true;
+}
@@ -0,0 +1,48 @@
+#ifndef INSTANTANEO_H
+#define INSTANTANEO_H
+
+#include "pico/stdlib.h"
+#include "flash_ops.h"
+
+// Instantâneo da ocupação, para voltar ao estado certo depois de um reset.
+//
+// Duas cópias: uma em RAM não inicializada (sobrevive a watchdog, botão de
+// reset e quedas breves de tensão), atualizada a cada mudança de ocupação,
+// e registros de 16 bytes anexados numa região de flash de dois setores,
+// gravados periodicamente pela tarefa do diário para a partida a frio.
+// Cada cópia tem seq e CRC-32; na partida vale a íntegra de maior seq.
+//
+// A restauração é limitada: a cópia em RAM é conferida direto e, em cada
+// setor, o último registro é achado por busca binária pelo primeiro espaço
+// em branco (8 leituras), recuando no máximo INSTANTANEO_RECUOS registros
+// se o último estiver corrompido.
+
+typedef struct
+{
+    uint32_t magico;
+    uint32_t seq;      // Cresce a cada mudança
+    uint16_t usuarios; // Ocupação
+    uint16_t reservado;
+    uint32_t crc;      // CRC-32 dos campos anteriores
+} instantaneo_t;
+
+typedef enum
+{
+    INSTANTANEO_NENHUM, // Nada íntegro: começa do zero
+    INSTANTANEO_RAM,
+    INSTANTANEO_FLASH
+} instantaneo_origem_t;
+
+// Procura a cópia mais recente e prepara a região de flash. Chamar antes
+// das interrupções e do escalonador; 'usuarios' recebe a ocupação salva
+// (0 se nada for achado).
+instantaneo_origem_t instantaneo_restaurar(const flash_ops_t *ops, uint16_t *usuarios);
+
+// Atualiza a cópia em RAM. Para a ISR, que é quem muda a ocupação.
+void instantaneo_atualizar(uint16_t usuarios);
+
+// Anexa a cópia em RAM à flash se ela mudou desde a última gravação.
+// Para a tarefa do diário (pode apagar um setor).
+bool instantaneo_gravar_flash(void);
+
+#endif /* INSTANTANEO_H */
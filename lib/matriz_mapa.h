@@ -0,0 +1,144 @@
+#ifndef MATRIZ_MAPA_H
+#define MATRIZ_MAPA_H
+
+#include <stdint.h>
+
+// Geometria da matriz de LEDs, resolvida em tempo de compilação. Qualquer
+// item pode ser trocado com -D no CMake (ex.: -DNP_PAINEIS_X=4 para quatro
+// painéis 5x5 encadeados lado a lado).
+//
+//   NP_PAINEL_LARGURA / NP_PAINEL_ALTURA  tamanho de um painel, em LEDs
+//   NP_PAINEIS_X / NP_PAINEIS_Y           painéis encadeados; a fita segue da
+//                                         esquerda para a direita e de cima
+//                                         para baixo
+//   NP_SERPENTINA                         1: linhas alternam de sentido
+//                                         0: todas no mesmo sentido
+//   NP_ROTACAO                            0, 90, 180 ou 270: giro (horário)
+//                                         da fiação em relação à imagem
+//
+// A BitDogLab tem um painel 5x5 em serpentina com o LED 0 no canto inferior
+// direito, o que equivale à rotação de 180 graus.
+
+#ifndef NP_PAINEL_LARGURA
+#define NP_PAINEL_LARGURA 5
+#endif
+#ifndef NP_PAINEL_ALTURA
+#define NP_PAINEL_ALTURA 5
+#endif
+#ifndef NP_PAINEIS_X
+#define NP_PAINEIS_X 1
+#endif
+#ifndef NP_PAINEIS_Y
+#define NP_PAINEIS_Y 1
+#endif
+#ifndef NP_SERPENTINA
+#define NP_SERPENTINA 1
+#endif
+#ifndef NP_ROTACAO
+#define NP_ROTACAO 180
+#endif
+
+#define NP_LARGURA (NP_PAINEL_LARGURA * NP_PAINEIS_X)
+#define NP_ALTURA (NP_PAINEL_ALTURA * NP_PAINEIS_Y)
+#define NP_PIXELS (NP_LARGURA * NP_ALTURA)
+
+#if NP_PIXELS > 2047
+#error "Matriz grande demais para o mapa (máximo de 2047 LEDs)"
+#endif
+
+#if NP_LARGURA < 5 || NP_ALTURA < 5
+#error "A matriz precisa comportar os sprites 5x5"
+#endif
+
+#if NP_PIXELS > 255
+typedef uint16_t np_indice_t;
+#else
+typedef uint8_t np_indice_t;
+#endif
+
+// Coordenada (x, y) da imagem dentro do painel -> (u, v) na orientação da
+// fiação, cuja largura é NP_FIO_LARGURA
+#define NP_W NP_PAINEL_LARGURA
+#define NP_H NP_PAINEL_ALTURA
+#if NP_ROTACAO == 0
+#define NP_FIO_U(x, y) (x)
+#define NP_FIO_V(x, y) (y)
+#define NP_FIO_LARGURA NP_W
+#elif NP_ROTACAO == 90
+#define NP_FIO_U(x, y) (y)
+#define NP_FIO_V(x, y) (NP_W - 1 - (x))
+#define NP_FIO_LARGURA NP_H
+#elif NP_ROTACAO == 180
+#define NP_FIO_U(x, y) (NP_W - 1 - (x))
+#define NP_FIO_V(x, y) (NP_H - 1 - (y))
+#define NP_FIO_LARGURA NP_W
+#elif NP_ROTACAO == 270
+#define NP_FIO_U(x, y) (NP_H - 1 - (y))
+#define NP_FIO_V(x, y) (x)
+#define NP_FIO_LARGURA NP_H
+#else
+#error "NP_ROTACAO deve ser 0, 90, 180 ou 270"
+#endif
+
+// Posição na fita de (u, v) dentro de um painel
+#define NP_FIO(u, v) \
+    ((v) * NP_FIO_LARGURA + ((NP_SERPENTINA && ((v) & 1)) ? NP_FIO_LARGURA - 1 - (u) : (u)))
+
+// Posição na fita do pixel (x, y) da matriz inteira
+#define NP_XY(x, y)                                                                 \
+    ((((y) / NP_H) * NP_PAINEIS_X + (x) / NP_W) * (NP_W * NP_H) +                   \
+     NP_FIO(NP_FIO_U((x) % NP_W, (y) % NP_H), NP_FIO_V((x) % NP_W, (y) % NP_H)))
+
+// Tabela gerada pelo pré-processador: uma entrada por pixel, em ordem de
+// linha. Os blocos de 2^k entradas são incluídos conforme os bits de
+// NP_PIXELS, então a tabela tem exatamente o tamanho da matriz.
+#define NP_MAPA_ITEM(i) NP_XY((i) % NP_LARGURA, (i) / NP_LARGURA),
+#define NP_R1(b) NP_MAPA_ITEM(b)
+#define NP_R2(b) NP_R1(b) NP_R1((b) + 1)
+#define NP_R4(b) NP_R2(b) NP_R2((b) + 2)
+#define NP_R8(b) NP_R4(b) NP_R4((b) + 4)
+#define NP_R16(b) NP_R8(b) NP_R8((b) + 8)
+#define NP_R32(b) NP_R16(b) NP_R16((b) + 16)
+#define NP_R64(b) NP_R32(b) NP_R32((b) + 32)
+#define NP_R128(b) NP_R64(b) NP_R64((b) + 64)
+#define NP_R256(b) NP_R128(b) NP_R128((b) + 128)
+#define NP_R512(b) NP_R256(b) NP_R256((b) + 256)
+#define NP_R1024(b) NP_R512(b) NP_R512((b) + 512)
+
+static const np_indice_t np_mapa[NP_PIXELS] = {
+#if NP_PIXELS & 1024
+    NP_R1024(0)
+#endif
+#if NP_PIXELS & 512
+    NP_R512(NP_PIXELS & 1024)
+#endif
+#if NP_PIXELS & 256
+    NP_R256(NP_PIXELS & 1536)
+#endif
+#if NP_PIXELS & 128
+    NP_R128(NP_PIXELS & 1792)
+#endif
+#if NP_PIXELS & 64
+    NP_R64(NP_PIXELS & 1920)
+#endif
+#if NP_PIXELS & 32
+    NP_R32(NP_PIXELS & 1984)
+#endif
+#if NP_PIXELS & 16
+    NP_R16(NP_PIXELS & 2016)
+#endif
+#if NP_PIXELS & 8
+    NP_R8(NP_PIXELS & 2032)
+#endif
+#if NP_PIXELS & 4
+    NP_R4(NP_PIXELS & 2040)
+#endif
+#if NP_PIXELS & 2
+    NP_R2(NP_PIXELS & 2044)
+#endif
+#if NP_PIXELS & 1
+    NP_R1(NP_PIXELS & 2046)
+#endif
+};
+
+#endif /* MATRIZ_MAPA_H */
@@ -1,12 +1,15 @@
 #include "ws2818b.pio.h"
-#include <math.h> // Inclua a biblioteca para usar round()
 #include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "sprites.h"
+#include "matriz_mapa.h"
+#include "rastreio.h"
 
 // funcionamento da mztriz de led---------------------------------------------------------------------------------------------
 //  Biblioteca gerada pelo arquivo .pio durante compilação.
 
-// Definição do número de LEDs e pino.
-#define LED_COUNT 25
+// Definição do número de LEDs (geometria em matriz_mapa.h) e pino.
+#define LED_COUNT NP_PIXELS
 #define LED_PIN 7
 
 // Definição de pixel GRB
@@ -23,6 +26,51 @@ npLED_t leds[LED_COUNT];
 PIO np_pio;
 uint sm;
 
+// Envio por DMA: cada LED vira uma palavra de 24 bits (G nos bits 0-7, R em
+// 8-15, B em 16-23), consumida pela máquina PIO com autopull de 24 bits.
+#define NP_QUADRO_US (LED_COUNT * 24 * 10 / 8) // 1,25 us por bit a 800 kHz
+#define NP_RESET_US 100                        // Sinal de RESET do datasheet
+static uint32_t np_palavras[LED_COUNT];
+static int np_dma;
+static volatile bool np_ocupado = false; // Quadro em envio ou em latch
+RASTREIO_SO(static uint16_t np_seq_proximo;)      // Evento do próximo quadro
+RASTREIO_SO(static volatile uint16_t np_seq;)     // Evento do quadro em envio
+
+// Chamado pelo alarme de hardware quando o quadro terminou e o latch passou
+static int64_t npLatchConcluido(alarm_id_t id, void *user_data)
+{
+  RASTREIO_MARCA(RASTREIO_MATRIZ, np_seq);
+  np_ocupado = false;
+  return 0;
+}
+
+// Estágio de brilho e gama: as paletas guardam cores em escala perceptual
+// (0-255); ao gravar em 'leds' cada canal é escalado pelo brilho global em
+// ponto fixo 8.8 (0x0100 = 1,0) e passa pela tabela de gama 2,2 abaixo.
+// Só inteiros: o Cortex-M0+ não tem FPU.
+#define NP_BRILHO_PADRAO 0x0100
+static uint16_t np_brilho = NP_BRILHO_PADRAO;
+
+// NP_GAMMA[v] = round(255 * (v / 255)^2,2)
+static const uint8_t NP_GAMMA[256] = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+      6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+     12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+     20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+     30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+     42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+     56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+     73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+     91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255,
+};
+
 /**
  * Inicializa a máquina PIO para controle da matriz de LEDs.
  */
@@ -44,6 +92,15 @@ void npInit(uint pin)
   // Inicia programa na máquina PIO obtida.
   ws2818b_program_init(np_pio, sm, offset, LED_PIN, 800000.f);
 
+  // Canal de DMA que alimenta a FIFO TX da máquina no ritmo do seu DREQ.
+  np_dma = dma_claim_unused_channel(true);
+  dma_channel_config c = dma_channel_get_default_config(np_dma);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+  channel_config_set_read_increment(&c, true);
+  channel_config_set_write_increment(&c, false);
+  channel_config_set_dreq(&c, pio_get_dreq(np_pio, sm, true));
+  dma_channel_configure(np_dma, &c, &np_pio->txf[sm], np_palavras, LED_COUNT, false);
+
   // Limpa buffer de pixels.
   for (uint i = 0; i < LED_COUNT; ++i)
   {
@@ -63,6 +120,29 @@ void npSetLED(const uint index, const uint8_t r, const uint8_t g, const uint8_t
   leds[index].B = b;
 }
 
+/**
+ * Define o brilho global em ponto fixo 8.8 (0x0100 = 1,0; 0x0080 = 0,5).
+ */
+void npSetBrilho(uint16_t brilho)
+{
+  np_brilho = brilho;
+}
+
+// Aplica brilho e gama a um canal
+static inline uint8_t npCorrige(uint8_t v)
+{
+  uint32_t e = ((uint32_t)v * np_brilho) >> 8;
+  return NP_GAMMA[e > 255 ? 255 : e];
+}
+
+/**
+ * Atribui a um LED uma cor de paleta, com brilho e gama aplicados.
+ */
+void npSetLEDCor(const uint index, const cor_t *cor)
+{
+  npSetLED(index, npCorrige(cor->r), npCorrige(cor->g), npCorrige(cor->b));
+}
+
 /**
  * Limpa o buffer de pixels.
  */
@@ -74,56 +154,54 @@ void npClear()
 
 /**
  * Escreve os dados do buffer nos LEDs.
+ * Empacota o buffer e dispara o DMA; retorna sem esperar o envio. Um alarme
+ * de hardware libera o próximo quadro depois do envio e do RESET, então só
+ * há espera se npWrite for chamada de novo em menos de ~1 ms.
  */
 void npWrite()
 {
-  // Escreve cada dado de 8-bits dos pixels em sequência no buffer da máquina PIO.
+  while (np_ocupado)
+    tight_loop_contents();
+
+  RASTREIO_SO(np_seq = np_seq_proximo; np_seq_proximo = 0;)
   for (uint i = 0; i < LED_COUNT; ++i)
+    np_palavras[i] = leds[i].G | (leds[i].R << 8) | ((uint32_t)leds[i].B << 16);
+
+  np_ocupado = true;
+  dma_channel_transfer_from_buffer_now(np_dma, np_palavras, LED_COUNT);
+  if (add_alarm_in_us(NP_QUADRO_US + NP_RESET_US, npLatchConcluido, NULL, true) < 0)
   {
-    pio_sm_put_blocking(np_pio, sm, (int)round(leds[i].G)); // Arredondamento para inteiro
-    pio_sm_put_blocking(np_pio, sm, (int)round(leds[i].R)); // Arredondamento para inteiro
-    pio_sm_put_blocking(np_pio, sm, (int)round(leds[i].B)); // Arredondamento para inteiro
+    // Sem alarme livre: garante o latch esperando aqui mesmo.
+    sleep_us(NP_QUADRO_US + NP_RESET_US);
+    RASTREIO_MARCA(RASTREIO_MATRIZ, np_seq);
+    np_ocupado = false;
   }
-  sleep_us(100); // Espera 100us, sinal de RESET do datasheet.
 }
 
-// Modificado do github: https://github.com/BitDogLab/BitDogLab-C/tree/main/neopixel_pio
-// Função para converter a posição do matriz para uma posição do vetor.
-int getIndex(int x, int y)
+#ifdef RASTREIO
+// O próximo npWrite leva o evento 'seq': sua conclusão marca a etapa da matriz
+void npRastrear(uint16_t seq)
 {
-  // Se a linha for par (0, 2, 4), percorremos da esquerda para a direita.
-  // Se a linha for ímpar (1, 3), percorremos da direita para a esquerda.
-  if (y % 2 == 0)
-  {
-    return 24 - (y * 5 + x); // Linha par (esquerda para direita).
-  }
-  else
-  {
-    return 24 - (y * 5 + (4 - x)); // Linha ímpar (direita para esquerda).
-  }
+  np_seq_proximo = seq;
 }
+#endif
 
+// Posição na fita do pixel (x, y), lida do mapa gerado em compilação.
+int getIndex(int x, int y)
+{
+  return np_mapa[y * NP_LARGURA + x];
+}
 
-
-void desenhaSprite(int matriz[5][5][3], float intensidade)
+// Decodifica um sprite da flash direto no buffer 'leds', passando cada cor
+// da paleta pelo estágio de brilho e gama.
+// O sprite é desenhado no canto superior esquerdo da matriz.
+void desenhaSprite(const sprite_t *sprite, const cor_t *paleta)
 {
-  for (int linha = 0; linha < 5; linha++)
+  int i = 0;
+  for (int y = 0; y < SPRITE_LADO; y++)
   {
-    for (int coluna = 0; coluna < 5; coluna++)
-    {
-      int posicao = getIndex(linha, coluna);
-      
-      // Converta o resultado da multiplicação explicitamente para int
-      int r = (int)(matriz[coluna][linha][0]*intensidade);
-      int g = (int)(matriz[coluna][linha][1] *intensidade);
-      int b = (int)(matriz[coluna][linha][2] *intensidade);
-
-        
-      // Configure o LED
-      npSetLED(posicao, r, g, b);
-
-      // Exiba os valores para depuração
-    
-    }
+    const np_indice_t *linha = &np_mapa[y * NP_LARGURA];
+    for (int x = 0; x < SPRITE_LADO; x++, i++)
+      npSetLEDCor(linha[x], &paleta[sprite_indice(sprite, i)]);
   }
-}
\ No newline at end of file
+}
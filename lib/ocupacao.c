@@ -0,0 +1,52 @@
+#include "ocupacao.h"
+
+void ocupacao_iniciar(ocupacao_t *ocupacao, uint16_t maximo)
+{
+    ocupacao->ativos = 0;
+    ocupacao->maximo = maximo;
+    ocupacao->lock = spin_lock_init(spin_lock_claim_unused(true));
+}
+
+// Admite uma entrada se houver vaga. Retorna true se admitida; em
+// 'resultante' fica a ocupação após a decisão.
+bool ocupacao_entrar(ocupacao_t *ocupacao, uint16_t *resultante)
+{
+    uint32_t irq = spin_lock_blocking(ocupacao->lock);
+    bool admitido = ocupacao->ativos < ocupacao->maximo;
+    if (admitido)
+    {
+        ocupacao->ativos++;
+    }
+    *resultante = ocupacao->ativos;
+    spin_unlock(ocupacao->lock, irq);
+    return admitido;
+}
+
+// Registra uma saída se houver alguém dentro. Retorna true se registrada.
+bool ocupacao_sair(ocupacao_t *ocupacao, uint16_t *resultante)
+{
+    uint32_t irq = spin_lock_blocking(ocupacao->lock);
+    bool registrado = ocupacao->ativos > 0;
+    if (registrado)
+    {
+        ocupacao->ativos--;
+    }
+    *resultante = ocupacao->ativos;
+    spin_unlock(ocupacao->lock, irq);
+    return registrado;
+}
+
+void ocupacao_zerar(ocupacao_t *ocupacao)
+{
+    uint32_t irq = spin_lock_blocking(ocupacao->lock);
+    ocupacao->ativos = 0;
+    spin_unlock(ocupacao->lock, irq);
+}
+
+// Retoma uma contagem salva (limitada ao máximo), antes das interrupções
+void ocupacao_restaurar(ocupacao_t *ocupacao, uint16_t ativos)
+{
+    uint32_t irq = spin_lock_blocking(ocupacao->lock);
+    ocupacao->ativos = ativos < ocupacao->maximo ? ativos : ocupacao->maximo;
+    spin_unlock(ocupacao->lock, irq);
+}
@@ -0,0 +1,30 @@
+#ifndef OCUPACAO_H
+#define OCUPACAO_H
+
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+// Estado único de ocupação. Todas as operações de escrita rodam numa seção
+// crítica curta protegida por um spinlock de hardware do RP2040 (que também
+// desabilita interrupções no núcleo atual), então podem ser chamadas tanto
+// de tarefas quanto da ISR dos botões, com latência limitada.
+typedef struct
+{
+    volatile uint16_t ativos;
+    uint16_t maximo;
+    spin_lock_t *lock;
+} ocupacao_t;
+
+void ocupacao_iniciar(ocupacao_t *ocupacao, uint16_t maximo);
+bool ocupacao_entrar(ocupacao_t *ocupacao, uint16_t *resultante);
+bool ocupacao_sair(ocupacao_t *ocupacao, uint16_t *resultante);
+void ocupacao_zerar(ocupacao_t *ocupacao);
+void ocupacao_restaurar(ocupacao_t *ocupacao, uint16_t ativos);
+
+// Leitura sem trava: a escrita de 16 bits é atômica no Cortex-M0+
+static inline uint16_t ocupacao_ler(const ocupacao_t *ocupacao)
+{
+    return ocupacao->ativos;
+}
+
+#endif /* OCUPACAO_H */
@@ -0,0 +1,213 @@
+#include "perfil.h"
+#include "task.h"
+#include "estatico.h"
+#include <stdio.h>
+
+#ifndef configRUN_TIME_COUNTER_TYPE
+#define configRUN_TIME_COUNTER_TYPE uint32_t
+#endif
+
+typedef struct
+{
+    QueueHandle_t fila;
+    const char *nome;
+    volatile uint32_t pico; // Maior ocupação no período, medida a cada envio
+} perfil_fila_t;
+
+static perfil_fila_t filas[PERFIL_MAX_FILAS];
+static uint8_t n_filas;
+static perfil_espera_t *esperas[PERFIL_MAX_ESPERAS];
+static uint8_t n_esperas;
+
+typedef struct
+{
+    const volatile uint32_t *contador;
+    const char *nome;
+    uint32_t anterior; // Valor no relatório anterior
+} perfil_contador_t;
+
+static perfil_contador_t contadores[PERFIL_MAX_CONTADORES];
+static uint8_t n_contadores;
+
+// Chamada pelo traceQUEUE_SEND(_FROM_ISR) do FreeRTOSConfig.h em cada envio
+// (também de semáforos), com a fila travada; as não registradas são
+// ignoradas
+void perfil_fila_nivel(void *fila, uint32_t nivel)
+{
+    for (uint8_t i = 0; i < n_filas; i++)
+    {
+        if ((void *)filas[i].fila == fila)
+        {
+            if (nivel > filas[i].pico)
+            {
+                filas[i].pico = nivel;
+            }
+            return;
+        }
+    }
+}
+
+void perfil_registrar_fila(QueueHandle_t fila, const char *nome)
+{
+    if (n_filas < PERFIL_MAX_FILAS)
+    {
+        filas[n_filas++] = (perfil_fila_t){fila, nome, 0};
+    }
+    vQueueAddToRegistry(fila, nome); // Nome visível também no depurador
+}
+
+void perfil_registrar_espera(perfil_espera_t *espera, const char *nome)
+{
+    *espera = (perfil_espera_t){nome, 0, 0, 0};
+    if (n_esperas < PERFIL_MAX_ESPERAS)
+    {
+        esperas[n_esperas++] = espera;
+    }
+}
+
+void perfil_espera_fim(perfil_espera_t *espera, uint32_t inicio)
+{
+    uint32_t us = time_us_32() - inicio;
+    taskENTER_CRITICAL();
+    espera->n++;
+    espera->total_us += us;
+    if (us > espera->max_us)
+    {
+        espera->max_us = us;
+    }
+    taskEXIT_CRITICAL();
+}
+
+void perfil_registrar_contador(const volatile uint32_t *contador, const char *nome)
+{
+    if (n_contadores < PERFIL_MAX_CONTADORES)
+    {
+        contadores[n_contadores++] = (perfil_contador_t){contador, nome, *contador};
+    }
+}
+
+uint32_t perfil_contador_us(void)
+{
+    return time_us_32();
+}
+
+// Pilha estourada (configCHECK_FOR_STACK_OVERFLOW): a pilha já está
+// corrompida, então só resta parar com o nome da tarefa
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName)
+{
+    panic("Estouro de pilha na tarefa %s", pcTaskName);
+}
+
+#if configGENERATE_RUN_TIME_STATS
+
+// Tempo acumulado de cada tarefa no relatório anterior, para o % do período
+typedef struct
+{
+    TaskHandle_t tarefa;
+    configRUN_TIME_COUNTER_TYPE tempo;
+} perfil_anterior_t;
+
+static TaskStatus_t estados[PERFIL_MAX_TAREFAS];
+static perfil_anterior_t anteriores[PERFIL_MAX_TAREFAS];
+static uint8_t n_anteriores;
+static configRUN_TIME_COUNTER_TYPE total_anterior;
+static uint32_t periodo;
+
+static configRUN_TIME_COUNTER_TYPE tempo_anterior(TaskHandle_t tarefa)
+{
+    for (uint8_t i = 0; i < n_anteriores; i++)
+    {
+        if (anteriores[i].tarefa == tarefa)
+        {
+            return anteriores[i].tempo;
+        }
+    }
+    return 0; // Tarefa nova
+}
+
+static void relatorio(void)
+{
+    configRUN_TIME_COUNTER_TYPE total;
+    UBaseType_t n = uxTaskGetSystemState(estados, PERFIL_MAX_TAREFAS, &total);
+    configRUN_TIME_COUNTER_TYPE decorrido = total - total_anterior;
+
+    printf("\n--- perfil (%lu ms) ---\n", (unsigned long)(decorrido / 1000));
+    printf("%-14s %6s %8s\n", "tarefa", "CPU%", "pilha");
+    for (UBaseType_t i = 0; i < n; i++)
+    {
+        configRUN_TIME_COUNTER_TYPE uso = estados[i].ulRunTimeCounter - tempo_anterior(estados[i].xHandle);
+        uint32_t milesimos = decorrido ? (uint32_t)((uint64_t)uso * 1000 / decorrido) : 0;
+        printf("%-14s %3lu.%lu%% %8lu\n", estados[i].pcTaskName, (unsigned long)(milesimos / 10),
+               (unsigned long)(milesimos % 10), (unsigned long)estados[i].usStackHighWaterMark);
+    }
+
+    // Guarda os acumulados para o próximo período
+    for (UBaseType_t i = 0; i < n; i++)
+    {
+        anteriores[i] = (perfil_anterior_t){estados[i].xHandle, estados[i].ulRunTimeCounter};
+    }
+    n_anteriores = n;
+    total_anterior = total;
+
+    for (uint8_t i = 0; i < n_filas; i++)
+    {
+        // O pico recomeça do nível atual a cada relatório
+        taskENTER_CRITICAL();
+        UBaseType_t usadas = uxQueueMessagesWaiting(filas[i].fila);
+        uint32_t pico = filas[i].pico > usadas ? filas[i].pico : usadas;
+        filas[i].pico = usadas;
+        taskEXIT_CRITICAL();
+        UBaseType_t tamanho = usadas + uxQueueSpacesAvailable(filas[i].fila);
+        printf("fila %-10s %2lu/%lu (pico %lu)\n", filas[i].nome, (unsigned long)usadas,
+               (unsigned long)tamanho, (unsigned long)pico);
+    }
+
+    for (uint8_t i = 0; i < n_esperas; i++)
+    {
+        perfil_espera_t e;
+        taskENTER_CRITICAL();
+        e = *esperas[i];
+        esperas[i]->n = esperas[i]->total_us = esperas[i]->max_us = 0;
+        taskEXIT_CRITICAL();
+        printf("espera %-12s n=%lu media=%lu us max=%lu us\n", e.nome, (unsigned long)e.n,
+               (unsigned long)(e.n ? e.total_us / e.n : 0), (unsigned long)e.max_us);
+    }
+
+    for (uint8_t i = 0; i < n_contadores; i++)
+    {
+        uint32_t valor = *contadores[i].contador;
+        printf("contador %-14s +%lu\n", contadores[i].nome, (unsigned long)(valor - contadores[i].anterior));
+        contadores[i].anterior = valor;
+    }
+
+#if configSUPPORT_DYNAMIC_ALLOCATION
+    printf("heap livre %lu, minimo %lu\n", (unsigned long)xPortGetFreeHeapSize(),
+           (unsigned long)xPortGetMinimumEverFreeHeapSize());
+#else
+    printf("sem heap (alocacao estatica)\n");
+#endif
+}
+
+static void vTaskPerfil(void *params)
+{
+    TickType_t proximo = xTaskGetTickCount();
+    while (true)
+    {
+        vTaskDelayUntil(&proximo, pdMS_TO_TICKS(periodo));
+        relatorio();
+    }
+}
+
+void perfil_iniciar(uint32_t periodo_ms, UBaseType_t prioridade)
+{
+    periodo = periodo_ms;
+    CRIAR_TAREFA(vTaskPerfil, "PerfilTask", configMINIMAL_STACK_SIZE + 256, NULL, prioridade, NULL);
+}
+
+#else
+
+void perfil_iniciar(uint32_t periodo_ms, UBaseType_t prioridade)
+{
+}
+
+#endif /* configGENERATE_RUN_TIME_STATS */
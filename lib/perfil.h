@@ -0,0 +1,53 @@
+#ifndef PERFIL_H
+#define PERFIL_H
+
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "queue.h"
+
+// Perfil de execução. Com -DPERFIL=ON o FreeRTOS conta o tempo de CPU de
+// cada tarefa com o timer de 1 us do RP2040 e uma tarefa imprime na USB,
+// a cada período:
+//   - % de CPU de cada tarefa no período e a folga mínima da pilha;
+//   - ocupação atual das filas registradas e o pico no período, medido a
+//     cada envio (traceQUEUE_SEND), não só na hora do relatório;
+//   - número, média e máximo das esperas registradas (ex.: semáforos);
+//   - quanto cada contador registrado andou no período (ex.: bytes no I2C);
+//   - heap livre e o mínimo já visto (heap_4; não há heap com ESTATICO).
+// Sem a opção, o registro de filas e esperas continua valendo (custa uma
+// leitura do timer por espera) e nada é impresso.
+
+#define PERFIL_MAX_FILAS 8
+#define PERFIL_MAX_ESPERAS 4
+#define PERFIL_MAX_CONTADORES 4
+#define PERFIL_MAX_TAREFAS 16
+
+typedef struct
+{
+    const char *nome;
+    uint32_t n;        // Esperas no período
+    uint32_t total_us; // Soma no período
+    uint32_t max_us;   // Maior no período
+} perfil_espera_t;
+
+void perfil_registrar_fila(QueueHandle_t fila, const char *nome);
+void perfil_registrar_espera(perfil_espera_t *espera, const char *nome);
+
+// Contador crescente mantido por outro módulo; só é lido no relatório
+void perfil_registrar_contador(const volatile uint32_t *contador, const char *nome);
+
+// Marca o início de uma espera; passe o valor a perfil_espera_fim
+static inline uint32_t perfil_agora(void)
+{
+    return time_us_32();
+}
+
+void perfil_espera_fim(perfil_espera_t *espera, uint32_t inicio);
+
+// Cria a tarefa que imprime o relatório a cada 'periodo_ms' (só com PERFIL)
+void perfil_iniciar(uint32_t periodo_ms, UBaseType_t prioridade);
+
+// Contador de tempo de execução (portGET_RUN_TIME_COUNTER_VALUE)
+uint32_t perfil_contador_us(void);
+
+#endif /* PERFIL_H */
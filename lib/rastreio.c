@@ -0,0 +1,68 @@
+#include "rastreio.h"
+
+#ifdef RASTREIO
+
+#include "FreeRTOS.h"
+#include "console.h"
+#include <stdio.h>
+
+uint32_t rastreio_t0[RASTREIO_JANELA];
+volatile uint32_t rastreio_hist[RASTREIO_ETAPAS][RASTREIO_BALDES];
+uint16_t rastreio_ultimo;
+
+static const char *const ETAPAS[RASTREIO_ETAPAS] = {
+    [RASTREIO_OCUPACAO] = "ocupacao",
+    [RASTREIO_FILA] = "fila",
+    [RASTREIO_LED] = "led rgb",
+    [RASTREIO_DISPLAY] = "oled",
+    [RASTREIO_MATRIZ] = "matriz",
+};
+
+void rastreio_imprimir(void)
+{
+    printf("\n--- latencia desde a ISR (balde: < 2^k us) ---\n");
+    for (int e = 0; e < RASTREIO_ETAPAS; e++)
+    {
+        uint32_t total = 0;
+        printf("%-9s", ETAPAS[e]);
+        for (int b = 0; b < RASTREIO_BALDES; b++)
+        {
+            uint32_t n = rastreio_hist[e][b];
+            if (n)
+            {
+                printf(" <%lu:%lu", 1ul << b, (unsigned long)n);
+                total += n;
+            }
+        }
+        printf("  (n=%lu)\n", (unsigned long)total);
+    }
+}
+
+void rastreio_zerar(void)
+{
+    for (int e = 0; e < RASTREIO_ETAPAS; e++)
+    {
+        for (int b = 0; b < RASTREIO_BALDES; b++)
+        {
+            rastreio_hist[e][b] = 0;
+        }
+    }
+}
+
+static void comando_imprimir(const char *argumentos)
+{
+    rastreio_imprimir();
+}
+
+static void comando_zerar(const char *argumentos)
+{
+    rastreio_zerar();
+}
+
+void rastreio_iniciar(void)
+{
+    console_registrar('h', comando_imprimir);
+    console_registrar('z', comando_zerar);
+}
+
+#endif /* RASTREIO */
@@ -0,0 +1,83 @@
+#ifndef RASTREIO_H
+#define RASTREIO_H
+
+#include "pico/stdlib.h"
+
+// Rastreio de latência de ponta a ponta (cmake -DRASTREIO=ON).
+//
+// Cada evento de botão recebe na ISR um número de sequência e a marca de
+// tempo da entrada na ISR. Ao passar por cada etapa, o tempo decorrido
+// desde a ISR cai num histograma logarítmico da etapa: o balde k conta
+// latências em [2^(k-1), 2^k) us e o balde 0 conta as abaixo de 1 us. Uma
+// marca custa uma leitura do timer, um CLZ (ROM do RP2040) e um incremento.
+// Sem a opção, as macros somem e os campos de sequência não existem.
+//
+// Os histogramas saem no console (lib/console.h) sob demanda: 'h' imprime,
+// 'z' zera.
+
+typedef enum
+{
+    RASTREIO_OCUPACAO, // Decisão de ocupação gravada (na ISR)
+    RASTREIO_FILA,     // Evento recebido pela tarefa de entrada/saída
+    RASTREIO_LED,      // LED RGB atualizado pela tarefa de renderização
+    RASTREIO_DISPLAY,  // Envio do quadro ao OLED concluído (IRQ do DMA)
+    RASTREIO_MATRIZ,   // Primeiro quadro da animação travado na matriz
+    RASTREIO_ETAPAS
+} rastreio_etapa_t;
+
+#ifdef RASTREIO
+
+#define RASTREIO_BALDES 24 // Até ~4 s; o último acumula o que passar
+#define RASTREIO_JANELA 64 // Eventos em trânsito lembrados (potência de 2)
+
+extern uint32_t rastreio_t0[RASTREIO_JANELA];
+extern volatile uint32_t rastreio_hist[RASTREIO_ETAPAS][RASTREIO_BALDES];
+extern uint16_t rastreio_ultimo;
+
+// Novo evento (só na ISR dos botões). A sequência 0 significa "sem evento".
+static inline uint16_t rastreio_inicio(absolute_time_t entrada)
+{
+    uint16_t seq = ++rastreio_ultimo;
+    if (seq == 0)
+    {
+        seq = ++rastreio_ultimo;
+    }
+    rastreio_t0[seq & (RASTREIO_JANELA - 1)] = (uint32_t)to_us_since_boot(entrada);
+    return seq;
+}
+
+// Sem trava: as etapas são marcadas quase sempre de um só contexto, e uma
+// contagem perdida numa preempção rara não muda o histograma
+static inline void rastreio_marca(rastreio_etapa_t etapa, uint16_t seq)
+{
+    if (seq)
+    {
+        uint32_t dt = time_us_32() - rastreio_t0[seq & (RASTREIO_JANELA - 1)];
+        uint32_t balde = dt ? 32 - __builtin_clz(dt) : 0;
+        rastreio_hist[etapa][balde < RASTREIO_BALDES ? balde : RASTREIO_BALDES - 1]++;
+    }
+}
+
+void rastreio_imprimir(void);
+void rastreio_zerar(void);
+
+// Registra 'h' e 'z' no console
+void rastreio_iniciar(void);
+
+#define RASTREIO_CAMPO(decl) decl                       // Campo de struct só com rastreio
+#define RASTREIO_SO(...) __VA_ARGS__                    // Código só com rastreio
+#define RASTREIO_INICIO(entrada) rastreio_inicio(entrada)
+#define RASTREIO_MARCA(etapa, seq) rastreio_marca(etapa, seq)
+#define RASTREIO_SEQ(x) (x)                             // Repassa a sequência (0 sem rastreio)
+
+#else
+
+#define RASTREIO_CAMPO(decl)
+#define RASTREIO_SO(...)
+#define RASTREIO_INICIO(entrada) 0
+#define RASTREIO_MARCA(etapa, seq) ((void)0)
+#define RASTREIO_SEQ(x) 0
+
+#endif /* RASTREIO */
+
+#endif /* RASTREIO_H */
@@ -0,0 +1,107 @@
+#ifndef SPRITES_H
+#define SPRITES_H
+
+#include <stdint.h>
+
+// Quadros da matriz 5x5 guardados em flash (const). Cada quadro são 25
+// índices de paleta de 4 bits, linha a linha, dois pixels por byte (o pixel
+// de índice par no nibble baixo): 13 bytes por quadro, contra 300 de RAM do
+// antigo int[5][5][3]. A cor vem de uma paleta de até 16 entradas, então o
+// mesmo desenho serve a animações de cores diferentes.
+
+#define SPRITE_LADO 5
+#define SPRITE_PIXELS (SPRITE_LADO * SPRITE_LADO)
+#define SPRITE_BYTES ((SPRITE_PIXELS + 1) / 2)
+
+typedef struct
+{
+    uint8_t r, g, b;
+} cor_t;
+
+typedef struct
+{
+    uint8_t px[SPRITE_BYTES];
+} sprite_t;
+
+// Índice de paleta do pixel i (i = y * SPRITE_LADO + x)
+static inline uint8_t sprite_indice(const sprite_t *s, int i)
+{
+    return (s->px[i >> 1] >> ((i & 1) << 2)) & 0x0F;
+}
+
+// Monta um sprite_t a partir dos 25 índices escritos como a matriz aparece
+#define SPRITE_PAR(a, b) (uint8_t)((a) | ((b) << 4))
+#define SPRITE(p0, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12,        \
+               p13, p14, p15, p16, p17, p18, p19, p20, p21, p22, p23, p24)   \
+    {{SPRITE_PAR(p0, p1), SPRITE_PAR(p2, p3), SPRITE_PAR(p4, p5),             \
+      SPRITE_PAR(p6, p7), SPRITE_PAR(p8, p9), SPRITE_PAR(p10, p11),           \
+      SPRITE_PAR(p12, p13), SPRITE_PAR(p14, p15), SPRITE_PAR(p16, p17),       \
+      SPRITE_PAR(p18, p19), SPRITE_PAR(p20, p21), SPRITE_PAR(p22, p23),       \
+      SPRITE_PAR(p24, 0)}}
+
+// Paletas (índice 0 = apagado). Valores em escala perceptual: passam pela
+// gama 2,2 ao serem gravados nos LEDs, e 58 sai como 10, o nível de sempre.
+#define COR_NIVEL 58
+static const cor_t PALETA_VERMELHA[] = {{0, 0, 0}, {COR_NIVEL, 0, 0}};
+static const cor_t PALETA_VERDE[] = {{0, 0, 0}, {0, COR_NIVEL, 0}};
+
+// Matriz inteira acesa (piscar do reset)
+static const sprite_t SPRITE_CHEIO = SPRITE(
+    1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1);
+
+// Boneco caminhando da esquerda para a direita. A entrada toca os quadros
+// em ordem com a paleta verde; a saída, de trás para frente com a vermelha.
+#define BONECO_QUADROS 9
+static const sprite_t BONECO[BONECO_QUADROS] = {
+    SPRITE(1, 0, 0, 0, 0,
+           1, 0, 0, 0, 0,
+           0, 0, 0, 0, 0,
+           0, 0, 0, 0, 0,
+           1, 0, 0, 0, 0),
+    SPRITE(0, 1, 0, 0, 0,
+           1, 1, 0, 0, 0,
+           0, 0, 0, 0, 0,
+           1, 0, 0, 0, 0,
+           1, 0, 0, 0, 0),
+    SPRITE(1, 0, 1, 0, 0,
+           1, 1, 1, 0, 0,
+           1, 0, 0, 0, 0,
+           0, 1, 0, 0, 0,
+           0, 0, 1, 0, 0),
+    SPRITE(0, 1, 0, 1, 0,
+           1, 1, 1, 1, 0,
+           0, 1, 0, 0, 0,
+           1, 0, 1, 0, 0,
+           0, 0, 1, 0, 0),
+    SPRITE(1, 0, 1, 0, 1,
+           1, 1, 1, 1, 1,
+           0, 0, 1, 0, 0,
+           0, 1, 0, 1, 0,
+           0, 1, 0, 0, 1),
+    SPRITE(0, 1, 0, 1, 0,
+           0, 1, 1, 1, 1,
+           0, 0, 0, 1, 0,
+           0, 0, 1, 0, 1,
+           0, 1, 0, 0, 1),
+    SPRITE(0, 0, 1, 0, 1,
+           0, 0, 1, 1, 1,
+           0, 0, 0, 0, 1,
+           0, 0, 0, 1, 0,
+           0, 0, 0, 1, 0),
+    SPRITE(0, 0, 0, 1, 0,
+           0, 0, 0, 1, 1,
+           0, 0, 0, 0, 0,
+           0, 0, 0, 0, 1,
+           0, 0, 0, 1, 0),
+    SPRITE(0, 0, 0, 0, 1,
+           0, 0, 0, 0, 1,
+           0, 0, 0, 0, 0,
+           0, 0, 0, 0, 0,
+           0, 0, 0, 0, 0),
+};
+
+#endif
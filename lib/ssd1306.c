@@ -1,119 +1,442 @@
 #include "ssd1306.h"
 #include "font.h"
+#include <string.h>
 
-void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
+// Custo fixo, em bytes de payload, de cada janela enviada: byte de controle
+// 0x00 + 6 comandos de endereçamento, mais o byte de controle 0x40 dos dados.
+#define SSD1306_WINDOW_OVERHEAD 8
+
+// Maior lista de comandos enviada numa única transação
+#define SSD1306_MAX_COMMANDS 32
+
+static inline void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t page, uint8_t x0, uint8_t x1) {
+  if (x0 < ssd->dirty_x0[page])
+    ssd->dirty_x0[page] = x0;
+  if (x1 > ssd->dirty_x1[page])
+    ssd->dirty_x1[page] = x1;
+}
+
+static inline void ssd1306_clear_dirty(ssd1306_t *ssd) {
+  for (uint8_t p = 0; p < ssd->pages; ++p) {
+    ssd->dirty_x0[p] = 0xFF;
+    ssd->dirty_x1[p] = 0;
+  }
+}
+
+// Aloca o framebuffer no heap. Retorna false (e não inicializa) se faltar memória.
+bool ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
+  uint8_t *buffer = calloc(SSD1306_BUFSIZE(width, height), sizeof(uint8_t));
+  if (buffer == NULL)
+    return false;
+  ssd1306_init_with_buffer(ssd, width, height, external_vcc, address, i2c, buffer);
+  return true;
+}
+
+// Usa o framebuffer do chamador, com SSD1306_BUFSIZE(width, height) bytes
+void ssd1306_init_with_buffer(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address,
+                              i2c_inst_t *i2c, uint8_t *buffer) {
   ssd->width = width;
   ssd->height = height;
   ssd->pages = height / 8U;
   ssd->address = address;
   ssd->i2c_port = i2c;
-  ssd->bufsize = ssd->pages * ssd->width + 1;
-  ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  ssd->bufsize = SSD1306_BUFSIZE(width, height);
+  ssd->ram_buffer = buffer;
+  memset(ssd->ram_buffer, 0, ssd->bufsize);
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
+  ssd->flush_bytes = 0;
+  ssd->i2c_transactions = 0;
+  ssd->total_bytes = 0;
+  ssd->tx_buffer = NULL;
+  ssd->dma_channel = -1;
+  ssd->flush_busy = false;
+  ssd1306_invalidate(ssd); // A RAM do controlador tem conteúdo indefinido ao ligar
+}
+
+// Marca a tela inteira como alterada, forçando o próximo envio completo
+void ssd1306_invalidate(ssd1306_t *ssd) {
+  for (uint8_t p = 0; p < ssd->pages; ++p) {
+    ssd->dirty_x0[p] = 0;
+    ssd->dirty_x1[p] = ssd->width - 1;
+  }
 }
 
+// Sequência de inicialização, enviada numa única transação
+static const uint8_t ssd1306_init_sequence[] = {
+  SET_DISP | 0x00,
+  SET_MEM_ADDR, 0x01,
+  SET_DISP_START_LINE | 0x00,
+  SET_SEG_REMAP | 0x01,
+  SET_MUX_RATIO, HEIGHT - 1,
+  SET_COM_OUT_DIR | 0x08,
+  SET_DISP_OFFSET, 0x00,
+  SET_COM_PIN_CFG, 0x12,
+  SET_DISP_CLK_DIV, 0x80,
+  SET_PRECHARGE, 0xF1,
+  SET_VCOM_DESEL, 0x30,
+  SET_CONTRAST, 0xFF,
+  SET_ENTIRE_ON,
+  SET_NORM_INV,
+  SET_CHARGE_PUMP, 0x14,
+  SET_DISP | 0x01
+};
+
 void ssd1306_config(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_DISP | 0x00);
-  ssd1306_command(ssd, SET_MEM_ADDR);
-  ssd1306_command(ssd, 0x01);
-  ssd1306_command(ssd, SET_DISP_START_LINE | 0x00);
-  ssd1306_command(ssd, SET_SEG_REMAP | 0x01);
-  ssd1306_command(ssd, SET_MUX_RATIO);
-  ssd1306_command(ssd, HEIGHT - 1);
-  ssd1306_command(ssd, SET_COM_OUT_DIR | 0x08);
-  ssd1306_command(ssd, SET_DISP_OFFSET);
-  ssd1306_command(ssd, 0x00);
-  ssd1306_command(ssd, SET_COM_PIN_CFG);
-  ssd1306_command(ssd, 0x12);
-  ssd1306_command(ssd, SET_DISP_CLK_DIV);
-  ssd1306_command(ssd, 0x80);
-  ssd1306_command(ssd, SET_PRECHARGE);
-  ssd1306_command(ssd, 0xF1);
-  ssd1306_command(ssd, SET_VCOM_DESEL);
-  ssd1306_command(ssd, 0x30);
-  ssd1306_command(ssd, SET_CONTRAST);
-  ssd1306_command(ssd, 0xFF);
-  ssd1306_command(ssd, SET_ENTIRE_ON);
-  ssd1306_command(ssd, SET_NORM_INV);
-  ssd1306_command(ssd, SET_CHARGE_PUMP);
-  ssd1306_command(ssd, 0x14);
-  ssd1306_command(ssd, SET_DISP | 0x01);
+  ssd1306_command_list(ssd, ssd1306_init_sequence, sizeof(ssd1306_init_sequence));
+}
+
+// Toda escrita bloqueante passa por aqui para alimentar os contadores
+static void ssd1306_write(ssd1306_t *ssd, const uint8_t *data, size_t len) {
+  i2c_write_blocking(ssd->i2c_port, ssd->address, data, len, false);
+  ssd->flush_bytes += len;
+  ssd->total_bytes += len;
+  ssd->i2c_transactions++;
 }
 
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
+  ssd1306_flush_wait(ssd);
   ssd->port_buffer[1] = command;
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->port_buffer,
-    2,
-    false
-  );
+  ssd1306_write(ssd, ssd->port_buffer, 2);
+}
+
+// Envia vários comandos numa única transação: um byte de controle com Co=0
+// (0x00) seguido dos comandos, em vez de uma transação 0x80+comando para cada.
+void ssd1306_command_list(ssd1306_t *ssd, const uint8_t *commands, size_t len) {
+  uint8_t buffer[SSD1306_MAX_COMMANDS + 1];
+
+  ssd1306_flush_wait(ssd);
+  buffer[0] = 0x00;
+  while (len > 0) {
+    size_t n = len < SSD1306_MAX_COMMANDS ? len : SSD1306_MAX_COMMANDS;
+    for (size_t i = 0; i < n; ++i)
+      buffer[i + 1] = commands[i];
+    ssd1306_write(ssd, buffer, n + 1);
+    commands += n;
+    len -= n;
+  }
+}
+
+static void ssd1306_set_window(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1) {
+  const uint8_t cmds[6] = {SET_COL_ADDR, x0, x1, SET_PAGE_ADDR, p0, p1};
+  ssd1306_command_list(ssd, cmds, sizeof(cmds));
+}
+
+// Envia as colunas x0..x1 com todas as páginas. No modo de endereçamento
+// vertical essas colunas são contíguas no ram_buffer, então o byte anterior
+// à faixa é trocado temporariamente pelo byte de controle 0x40.
+static void ssd1306_send_columns(ssd1306_t *ssd, uint8_t x0, uint8_t x1) {
+  uint8_t *start = ssd->ram_buffer + x0 * ssd->pages;
+  size_t len = (size_t)(x1 - x0 + 1) * ssd->pages + 1;
+  uint8_t saved = start[0];
+
+  ssd1306_set_window(ssd, x0, x1, 0, ssd->pages - 1);
+  start[0] = 0x40;
+  ssd1306_write(ssd, start, len);
+  start[0] = saved;
+}
+
+// Envia as colunas x0..x1 de uma única página, copiando os bytes
+// (espaçados de ssd->pages no buffer) para um bloco contíguo.
+static void ssd1306_send_page(ssd1306_t *ssd, uint8_t page, uint8_t x0, uint8_t x1) {
+  uint8_t buffer[WIDTH + 1];
+  size_t len = 1;
+
+  buffer[0] = 0x40;
+  for (uint8_t x = x0; x <= x1; ++x)
+    buffer[len++] = ssd->ram_buffer[1 + page + x * ssd->pages];
+
+  ssd1306_set_window(ssd, x0, x1, page, page);
+  ssd1306_write(ssd, buffer, len);
+}
+
+// Decide como enviar as regiões alteradas: uma faixa de colunas de altura
+// total (uma janela só, x0..x1) ou uma janela por página suja, conforme o
+// que resultar em menos bytes no barramento.
+typedef enum {
+  SSD1306_PLAN_NONE,
+  SSD1306_PLAN_BAND,
+  SSD1306_PLAN_PAGES
+} ssd1306_plan_t;
+
+static ssd1306_plan_t ssd1306_plan_flush(ssd1306_t *ssd, uint8_t *x0, uint8_t *x1) {
+  uint32_t per_page = 0;
+
+  *x0 = 0xFF;
+  *x1 = 0;
+  for (uint8_t p = 0; p < ssd->pages; ++p) {
+    if (ssd->dirty_x0[p] > ssd->dirty_x1[p])
+      continue;
+    if (ssd->dirty_x0[p] < *x0)
+      *x0 = ssd->dirty_x0[p];
+    if (ssd->dirty_x1[p] > *x1)
+      *x1 = ssd->dirty_x1[p];
+    per_page += ssd->dirty_x1[p] - ssd->dirty_x0[p] + 1 + SSD1306_WINDOW_OVERHEAD;
+  }
+  if (*x0 > *x1)
+    return SSD1306_PLAN_NONE; // Nada mudou
+
+  uint32_t band = (uint32_t)(*x1 - *x0 + 1) * ssd->pages + SSD1306_WINDOW_OVERHEAD;
+  return band <= per_page ? SSD1306_PLAN_BAND : SSD1306_PLAN_PAGES;
 }
 
+// Envia apenas as regiões alteradas desde o último envio
 void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
-    false
-  );
+  uint8_t x0, x1;
+
+  ssd1306_flush_wait(ssd);
+  ssd->flush_bytes = 0;
+  switch (ssd1306_plan_flush(ssd, &x0, &x1)) {
+  case SSD1306_PLAN_NONE:
+    return;
+  case SSD1306_PLAN_BAND:
+    ssd1306_send_columns(ssd, x0, x1);
+    break;
+  case SSD1306_PLAN_PAGES:
+    for (uint8_t p = 0; p < ssd->pages; ++p) {
+      if (ssd->dirty_x0[p] <= ssd->dirty_x1[p])
+        ssd1306_send_page(ssd, p, ssd->dirty_x0[p], ssd->dirty_x1[p]);
+    }
+    break;
+  }
+  ssd1306_clear_dirty(ssd);
+}
+
+// ---------------------------------------------------------------------------
+// Envio assíncrono por DMA
+//
+// O controlador I2C do RP2040 recebe palavras de 16 bits no IC_DATA_CMD (byte
+// de dados + bits de RESTART/STOP), então o quadro é codificado em tx_buffer,
+// que funciona como buffer frontal: o DMA lê dele enquanto as tarefas
+// continuam desenhando em ram_buffer. Cada janela vira uma sequência de
+// transações separadas por RESTART, todas numa única transferência de DMA.
+// Só uma instância do display pode usar o modo assíncrono.
+// ---------------------------------------------------------------------------
+
+static ssd1306_t *ssd1306_async_owner = NULL;
+
+static void ssd1306_dma_irq_handler(void) {
+  ssd1306_t *ssd = ssd1306_async_owner;
+  if (ssd == NULL || !dma_channel_get_irq1_status(ssd->dma_channel))
+    return;
+  dma_channel_acknowledge_irq1(ssd->dma_channel);
+  ssd->flush_busy = false;
+  if (ssd->flush_done)
+    ssd->flush_done(ssd->flush_ctx);
+}
+
+// Aloca o buffer frontal no heap. Retorna false se faltar memória.
+bool ssd1306_async_init(ssd1306_t *ssd, ssd1306_flush_cb_t done, void *ctx) {
+  uint16_t *tx_buffer = calloc(SSD1306_TX_CAPACITY(ssd->width, ssd->height), sizeof(uint16_t));
+  if (tx_buffer == NULL)
+    return false;
+  return ssd1306_async_init_with_buffer(ssd, done, ctx, tx_buffer);
+}
+
+// Usa o buffer frontal do chamador, com SSD1306_TX_CAPACITY(width, height) palavras
+bool ssd1306_async_init_with_buffer(ssd1306_t *ssd, ssd1306_flush_cb_t done, void *ctx, uint16_t *tx_buffer) {
+  ssd->tx_capacity = SSD1306_TX_CAPACITY(ssd->width, ssd->height);
+  ssd->tx_buffer = tx_buffer;
+
+  ssd->dma_channel = dma_claim_unused_channel(true);
+  ssd->flush_done = done;
+  ssd->flush_ctx = ctx;
+  ssd->flush_busy = false;
+  ssd1306_async_owner = ssd;
+
+  dma_channel_config c = dma_channel_get_default_config(ssd->dma_channel);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+  channel_config_set_read_increment(&c, true);
+  channel_config_set_write_increment(&c, false);
+  channel_config_set_dreq(&c, i2c_get_dreq(ssd->i2c_port, true));
+  dma_channel_configure(ssd->dma_channel, &c, &i2c_get_hw(ssd->i2c_port)->data_cmd, ssd->tx_buffer, 0, false);
+
+  dma_channel_set_irq1_enabled(ssd->dma_channel, true);
+  irq_add_shared_handler(DMA_IRQ_1, ssd1306_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+  irq_set_enabled(DMA_IRQ_1, true);
+  return true;
+}
+
+static size_t ssd1306_encode_window(ssd1306_t *ssd, size_t n, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1) {
+  const uint8_t cmds[6] = {SET_COL_ADDR, x0, x1, SET_PAGE_ADDR, p0, p1};
+
+  ssd->tx_buffer[n] = 0x00 | (n ? I2C_IC_DATA_CMD_RESTART_BITS : 0);
+  n++;
+  for (uint8_t i = 0; i < 6; ++i)
+    ssd->tx_buffer[n++] = cmds[i];
+  ssd->tx_buffer[n++] = 0x40 | I2C_IC_DATA_CMD_RESTART_BITS;
+  ssd->i2c_transactions += 2;
+  for (uint8_t x = x0; x <= x1; ++x)
+    for (uint8_t p = p0; p <= p1; ++p)
+      ssd->tx_buffer[n++] = ssd->ram_buffer[1 + p + x * ssd->pages];
+  return n;
+}
+
+// Copia as regiões alteradas para o buffer frontal e inicia o DMA.
+// Se um envio anterior ainda estiver em andamento, espera por ele.
+// Retorna false quando não havia nada para enviar (o callback não é chamado).
+// Sem ssd1306_async_init, o envio é feito de forma bloqueante.
+bool ssd1306_send_data_async(ssd1306_t *ssd) {
+  uint8_t x0, x1;
+  size_t n = 0;
+
+  if (ssd->dma_channel < 0) {
+    ssd1306_send_data(ssd);
+    return false;
+  }
+
+  ssd1306_flush_wait(ssd);
+  ssd->flush_bytes = 0;
+  switch (ssd1306_plan_flush(ssd, &x0, &x1)) {
+  case SSD1306_PLAN_NONE:
+    return false;
+  case SSD1306_PLAN_BAND:
+    n = ssd1306_encode_window(ssd, n, x0, x1, 0, ssd->pages - 1);
+    break;
+  case SSD1306_PLAN_PAGES:
+    for (uint8_t p = 0; p < ssd->pages; ++p) {
+      if (ssd->dirty_x0[p] <= ssd->dirty_x1[p])
+        n = ssd1306_encode_window(ssd, n, ssd->dirty_x0[p], ssd->dirty_x1[p], p, p);
+    }
+    break;
+  }
+  ssd1306_clear_dirty(ssd);
+  ssd->tx_buffer[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+  ssd->flush_bytes = n;
+  ssd->total_bytes += n;
+
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  hw->enable = 0;
+  hw->tar = ssd->address;
+  hw->enable = 1;
+  ssd->flush_busy = true;
+  dma_channel_transfer_from_buffer_now(ssd->dma_channel, ssd->tx_buffer, n);
+  return true;
+}
+
+bool ssd1306_flush_busy(ssd1306_t *ssd) {
+  if (ssd->flush_busy)
+    return true;
+  // O DMA termina quando o último byte entra na FIFO; o barramento ainda
+  // pode estar transmitindo até 16 bytes depois disso.
+  uint32_t status = i2c_get_hw(ssd->i2c_port)->status;
+  return (status & I2C_IC_STATUS_ACTIVITY_BITS) || !(status & I2C_IC_STATUS_TFE_BITS);
+}
+
+void ssd1306_flush_wait(ssd1306_t *ssd) {
+  if (ssd->dma_channel < 0)
+    return;
+  while (ssd1306_flush_busy(ssd))
+    tight_loop_contents();
+}
+
+// Cancela um envio travado (por exemplo, NACK do display com o DMA parado
+// esperando a FIFO). A região enviada pela metade é marcada como suja.
+void ssd1306_flush_abort(ssd1306_t *ssd) {
+  if (ssd->dma_channel < 0)
+    return;
+  dma_channel_abort(ssd->dma_channel);
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  (void)hw->clr_tx_abrt;
+  hw->enable = 0;
+  ssd->flush_busy = false;
+  ssd1306_invalidate(ssd);
 }
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+  if (x >= ssd->width || y >= ssd->height)
+    return;
   uint16_t index = (y >> 3) + (x << 3) + 1;
   uint8_t pixel = (y & 0b111);
+  uint8_t old = ssd->ram_buffer[index];
   if (value)
     ssd->ram_buffer[index] |= (1 << pixel);
   else
     ssd->ram_buffer[index] &= ~(1 << pixel);
+  if (ssd->ram_buffer[index] != old)
+    ssd1306_mark_dirty(ssd, y >> 3, x, x);
 }
 
-/*
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-  uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
+// Aplica 'mask' (set ou clear) aos bytes da página 'page' nas colunas x0..x1,
+// marcando como sujas só as colunas cujo byte realmente mudou.
+static void ssd1306_span(ssd1306_t *ssd, uint8_t page, uint8_t x0, uint8_t x1, uint8_t mask, bool value) {
+  uint8_t *b = ssd->ram_buffer + 1 + page + x0 * ssd->pages;
+  int16_t first = -1, last = 0;
 
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
+  for (uint8_t x = x0; x <= x1; ++x, b += ssd->pages) {
+    uint8_t v = value ? (*b | mask) : (*b & ~mask);
+    if (v != *b) {
+      *b = v;
+      if (first < 0)
+        first = x;
+      last = x;
     }
+  }
+  if (first >= 0)
+    ssd1306_mark_dirty(ssd, page, first, last);
 }
 
+// Preenche o retângulo x0..x1, y0..y1 (inclusivo), recortado à tela. Cada
+// página coberta recebe uma corrida de bytes com as máscaras de topo e base.
+static void ssd1306_fill_area(ssd1306_t *ssd, int x0, int x1, int y0, int y1, bool value) {
+  if (x0 < 0)
+    x0 = 0;
+  if (y0 < 0)
+    y0 = 0;
+  if (x1 >= ssd->width)
+    x1 = ssd->width - 1;
+  if (y1 >= ssd->height)
+    y1 = ssd->height - 1;
+  if (x0 > x1 || y0 > y1)
+    return;
 
+  uint8_t p0 = y0 >> 3, p1 = y1 >> 3;
+  uint8_t top = 0xFF << (y0 & 7);
+  uint8_t bottom = 0xFF >> (7 - (y1 & 7));
 
-void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
-  for (uint8_t x = left; x < left + width; ++x) {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
-  }
-  for (uint8_t y = top; y < top + height; ++y) {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
+  if (p0 == p1) {
+    ssd1306_span(ssd, p0, x0, x1, top & bottom, value);
+    return;
   }
+  ssd1306_span(ssd, p0, x0, x1, top, value);
+  for (uint8_t p = p0 + 1; p < p1; ++p)
+    ssd1306_span(ssd, p, x0, x1, 0xFF, value);
+  ssd1306_span(ssd, p1, x0, x1, bottom, value);
+}
 
-  if (fill) {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
-        ssd1306_pixel(ssd, x, y, value);
+// Limpa/preenche a tela byte a byte. Equivale a um memset, mas compara cada
+// byte antes de escrever para que só o que mudou vá para o próximo envio.
+void ssd1306_fill(ssd1306_t *ssd, bool value) {
+  uint8_t byte = value ? 0xFF : 0x00;
+  uint8_t *b = ssd->ram_buffer + 1;
+
+  for (uint8_t x = 0; x < ssd->width; ++x) {
+    for (uint8_t p = 0; p < ssd->pages; ++p, ++b) {
+      if (*b != byte) {
+        *b = byte;
+        ssd1306_mark_dirty(ssd, p, x, x);
       }
     }
   }
 }
 
+void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+  if (width == 0 || height == 0)
+    return;
+
+  int right = left + width - 1;
+  int bottom = top + height - 1;
+
+  if (fill) {
+    ssd1306_fill_area(ssd, left, right, top, bottom, value);
+    return;
+  }
+  ssd1306_fill_area(ssd, left, right, top, top, value);
+  ssd1306_fill_area(ssd, left, right, bottom, bottom, value);
+  ssd1306_fill_area(ssd, left, left, top, bottom, value);
+  ssd1306_fill_area(ssd, right, right, top, bottom, value);
+}
+
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
     int dx = abs(x1 - x0);
     int dy = abs(y1 - y0);
@@ -144,13 +467,11 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 
 
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
+  ssd1306_fill_area(ssd, x0, x1, y, y, value);
 }
 
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
+  ssd1306_fill_area(ssd, x, x, y0, y1, value);
 }
 
 // Função para desenhar um caractere
@@ -169,13 +490,37 @@ void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
     index = 0; // Índice 0 corresponde ao caractere "nada" (espaço)
   }
 
-  // Desenha o caractere na tela
-  for (uint8_t i = 0; i < 8; ++i)
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+
+  // Cada byte da fonte é uma coluna de 8 pixels, no mesmo formato dos bytes
+  // do framebuffer. Com y alinhado à página a coluna substitui um byte; caso
+  // contrário, ela é dividida entre a página de y e a seguinte.
+  uint8_t page = y >> 3;
+  uint8_t shift = y & 7;
+  uint8_t mask_lo = 0xFF << shift;
+  uint8_t mask_hi = shift ? 0xFF >> (8 - shift) : 0;
+  bool has_hi = shift && page + 1 < ssd->pages;
+  uint8_t columns = ssd->width - x < 8 ? ssd->width - x : 8; // Recorte à direita
+  uint8_t *b = ssd->ram_buffer + 1 + page + x * ssd->pages;
+
+  for (uint8_t i = 0; i < columns; ++i, b += ssd->pages)
   {
-    uint8_t line = font[index + i]; // Acessa a linha correspondente do caractere na fonte
-    for (uint8_t j = 0; j < 8; ++j)
+    uint8_t line = font[index + i];
+    uint8_t v = (b[0] & ~mask_lo) | (uint8_t)(line << shift);
+    if (v != b[0])
     {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j)); // Desenha cada pixel do caractere
+      b[0] = v;
+      ssd1306_mark_dirty(ssd, page, x + i, x + i);
+    }
+    if (has_hi)
+    {
+      v = (b[1] & ~mask_hi) | (line >> (8 - shift));
+      if (v != b[1])
+      {
+        b[1] = v;
+        ssd1306_mark_dirty(ssd, page + 1, x + i, x + i);
+      }
     }
   }
 }
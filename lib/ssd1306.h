@@ -1,6 +1,11 @@
+#ifndef SSD1306_H
+#define SSD1306_H
+
 #include <stdlib.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
 
 #define WIDTH 128
 #define HEIGHT 64
@@ -25,6 +30,14 @@ typedef enum {
   SET_CHARGE_PUMP = 0x8D
 } ssd1306_command_t;
 
+typedef void (*ssd1306_flush_cb_t)(void *ctx);
+
+// Tamanho do framebuffer (byte de controle 0x40 + uma página por coluna)
+#define SSD1306_BUFSIZE(width, height) ((width) * ((height) / 8) + 1)
+// Palavras do buffer frontal no pior caso: faixa com a tela inteira
+// (controle + 6 comandos + dados)
+#define SSD1306_TX_CAPACITY(width, height) (SSD1306_BUFSIZE(width, height) + 7)
+
 typedef struct {
   uint8_t width, height, pages, address;
   i2c_inst_t *i2c_port;
@@ -32,12 +45,33 @@ typedef struct {
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
+  uint8_t dirty_x0[HEIGHT / 8]; // Menor coluna alterada em cada página (> dirty_x1: página limpa)
+  uint8_t dirty_x1[HEIGHT / 8]; // Maior coluna alterada em cada página
+  uint32_t flush_bytes;         // Bytes enviados pelo I2C no último envio
+  uint32_t i2c_transactions;    // Transações I2C desde ssd1306_init (START..STOP ou RESTART)
+  uint32_t total_bytes;         // Bytes enviados pelo I2C desde ssd1306_init
+  uint16_t *tx_buffer;          // Buffer frontal, já no formato IC_DATA_CMD, lido pelo DMA
+  size_t tx_capacity;
+  int dma_channel;              // -1 enquanto o envio assíncrono não for habilitado
+  volatile bool flush_busy;
+  ssd1306_flush_cb_t flush_done; // Chamado na IRQ do DMA ao fim de cada envio assíncrono
+  void *flush_ctx;
 } ssd1306_t;
 
-void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
+bool ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
+void ssd1306_init_with_buffer(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address,
+                              i2c_inst_t *i2c, uint8_t *buffer);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
+void ssd1306_command_list(ssd1306_t *ssd, const uint8_t *commands, size_t len);
 void ssd1306_send_data(ssd1306_t *ssd);
+void ssd1306_invalidate(ssd1306_t *ssd);
+bool ssd1306_async_init(ssd1306_t *ssd, ssd1306_flush_cb_t done, void *ctx);
+bool ssd1306_async_init_with_buffer(ssd1306_t *ssd, ssd1306_flush_cb_t done, void *ctx, uint16_t *tx_buffer);
+bool ssd1306_send_data_async(ssd1306_t *ssd);
+bool ssd1306_flush_busy(ssd1306_t *ssd);
+void ssd1306_flush_wait(ssd1306_t *ssd);
+void ssd1306_flush_abort(ssd1306_t *ssd);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
@@ -46,4 +80,6 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
-void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
\ No newline at end of file
+void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+
+#endif /* SSD1306_H */
@@ -0,0 +1,49 @@
+#include "ssd1306_ui.h"
+#include <string.h>
+
+void ssd1306_field_init(ssd1306_field_t *field, const char *name, uint8_t x, uint8_t y, uint8_t width, uint8_t height) {
+  field->name = name;
+  field->x = x;
+  field->y = y;
+  field->width = width;
+  field->height = height;
+  field->text[0] = '\0';
+  field->valid = false;
+}
+
+// Força o próximo ssd1306_field_set a redesenhar o campo
+void ssd1306_field_invalidate(ssd1306_field_t *field) {
+  field->valid = false;
+}
+
+// Atualiza o texto do campo. Se for igual ao que já está na tela não faz
+// nada e retorna false; caso contrário redesenha a caixa, quebrando linhas
+// dentro dela e descartando o que não couber. Os glifos sobrescrevem suas
+// células 8x8 por inteiro, então só o espaço que sobra em cada linha é
+// limpo; como o driver só marca bytes que mudaram, apenas as colunas
+// realmente diferentes vão para o próximo ssd1306_send_data.
+bool ssd1306_field_set(ssd1306_t *ssd, ssd1306_field_t *field, const char *text) {
+  if (field->valid && strncmp(field->text, text, SSD1306_FIELD_TEXT_MAX - 1) == 0)
+    return false;
+
+  strncpy(field->text, text, SSD1306_FIELD_TEXT_MAX - 1);
+  field->text[SSD1306_FIELD_TEXT_MAX - 1] = '\0';
+  field->valid = true;
+
+  int right = field->x + field->width;
+  int bottom = field->y + field->height;
+  const char *c = field->text;
+
+  for (int y = field->y; y < bottom; y += 8) {
+    int x = field->x;
+    if (y + 8 <= bottom) {
+      for (; *c && x + 8 <= right; ++c, x += 8)
+        ssd1306_draw_char(ssd, *c, x, y);
+    }
+    // Resto da linha (ou faixa final menor que um glifo)
+    uint8_t h = bottom - y < 8 ? bottom - y : 8;
+    if (x < right)
+      ssd1306_rect(ssd, y, x, right - x, h, false, true);
+  }
+  return true;
+}
@@ -0,0 +1,21 @@
+#ifndef SSD1306_UI_H
+#define SSD1306_UI_H
+
+#include "ssd1306.h"
+
+#define SSD1306_FIELD_TEXT_MAX 32
+
+// Campo de texto retido: uma caixa fixa na tela que guarda o último texto
+// desenhado e só é redesenhada quando o conteúdo muda.
+typedef struct {
+  const char *name;
+  uint8_t x, y, width, height;
+  char text[SSD1306_FIELD_TEXT_MAX];
+  bool valid; // false até o primeiro desenho ou após ssd1306_field_invalidate
+} ssd1306_field_t;
+
+void ssd1306_field_init(ssd1306_field_t *field, const char *name, uint8_t x, uint8_t y, uint8_t width, uint8_t height);
+bool ssd1306_field_set(ssd1306_t *ssd, ssd1306_field_t *field, const char *text);
+void ssd1306_field_invalidate(ssd1306_field_t *field);
+
+#endif /* SSD1306_UI_H */
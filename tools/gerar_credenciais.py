@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""Gera a tabela de credenciais autorizadas (lib/credencial.h) em C.
+
+Lê os IDs de um arquivo texto, um por linha, em decimal ou hexadecimal
+(0x...). Linhas vazias e o que vem depois de '#' são ignorados. Os IDs são
+embaralhados pela mesma bijeção de credencial_chave, ordenados e divididos
+em baldes pelos bits altos da chave.
+
+    python3 tools/gerar_credenciais.py credenciais.txt -o credenciais_tabela.c
+    python3 tools/gerar_credenciais.py --aleatorios 100000 --semente 1 --teste -o tabela.c
+
+Com --aleatorios N a lista é sorteada (IDs distintos de 32 bits). --teste
+acrescenta os IDs originais (CREDENCIAIS_TESTE_IDS) e outros tantos fora da
+lista (CREDENCIAIS_TESTE_AUSENTES), para o benchmark no PC conferir as buscas.
+"""
+
+import argparse
+import random
+import sys
+
+MEDIA_POR_BALDE = 16  # Alvo de chaves por balde: índice pequeno, busca curta
+LARGURA_LINHA = 6  # Valores por linha no C gerado
+
+
+def chave(i):
+    """Finalizador do MurmurHash3, igual a credencial_chave"""
+    i ^= i >> 16
+    i = (i * 0x85EBCA6B) & 0xFFFFFFFF
+    i ^= i >> 13
+    i = (i * 0xC2B2AE35) & 0xFFFFFFFF
+    i ^= i >> 16
+    return i
+
+
+def ler_lista(arquivo):
+    ids = []
+    with open(arquivo, encoding="utf-8") as f:
+        for n, linha in enumerate(f, 1):
+            texto = linha.split("#", 1)[0].strip()
+            if not texto:
+                continue
+            try:
+                valor = int(texto, 0)
+            except ValueError:
+                sys.exit(f"{arquivo}:{n}: ID invalido: {texto!r}")
+            if not 0 <= valor <= 0xFFFFFFFF:
+                sys.exit(f"{arquivo}:{n}: ID fora de 32 bits: {texto}")
+            ids.append(valor)
+    return ids
+
+
+def sortear(n, semente):
+    rng = random.Random(semente)
+    ids = set()
+    while len(ids) < n:
+        ids.add(rng.getrandbits(32))
+    return list(ids)
+
+
+def ausentes(ids, n, semente):
+    """n IDs fora da lista, para as buscas sem sucesso"""
+    rng = random.Random(semente ^ 0x5A5A5A5A)
+    existentes = set(ids)
+    fora = []
+    while len(fora) < n:
+        i = rng.getrandbits(32)
+        if i not in existentes:
+            fora.append(i)
+    return fora
+
+
+def bits_para(n):
+    bits = 0
+    while (n >> (bits + 1)) >= MEDIA_POR_BALDE:
+        bits += 1
+    return bits
+
+
+def vetor_c(nome, valores, tipo="const uint32_t"):
+    linhas = [f"{tipo} {nome}[{len(valores)}] = {{"]
+    for k in range(0, len(valores), LARGURA_LINHA):
+        linhas.append("    " + ", ".join(f"0x{v:08x}" for v in valores[k : k + LARGURA_LINHA]) + ",")
+    linhas.append("};")
+    return "\n".join(linhas)
+
+
+def gerar(ids, origem, teste, semente):
+    unicos = sorted(set(ids))
+    if len(unicos) != len(ids):
+        print(f"aviso: {len(ids) - len(unicos)} IDs repetidos ignorados", file=sys.stderr)
+    if not unicos:
+        sys.exit("lista de credenciais vazia")
+
+    chaves = sorted(chave(i) for i in unicos)
+    bits = bits_para(len(chaves))
+    baldes = [0] * ((1 << bits) + 1)
+    for c in chaves:
+        baldes[(c >> (32 - bits)) + 1 if bits else 1] += 1
+    for b in range(1, len(baldes)):
+        baldes[b] += baldes[b - 1]
+    maior = max(baldes[b + 1] - baldes[b] for b in range(len(baldes) - 1))
+    if maior > 0xFFFF:
+        sys.exit("balde com mais de 65535 chaves")
+
+    partes = [
+        f"// Gerado por tools/gerar_credenciais.py a partir de {origem}. Não edite.",
+        f"// {len(chaves)} credenciais, {1 << bits} baldes, maior balde com {maior} chaves",
+        "",
+        '#include "credencial.h"',
+        "",
+        vetor_c("credenciais_chaves", chaves, "static const uint32_t"),
+        "",
+        vetor_c("credenciais_baldes", baldes, "static const uint32_t"),
+        "",
+        "const credencial_tabela_t CREDENCIAIS_AUTORIZADAS = {",
+        f"    credenciais_chaves, credenciais_baldes, {len(chaves)}, {bits}, {maior}}};",
+        "",
+        f"uint32_t credenciais_presentes[{(len(chaves) + 31) // 32}];",
+        "",
+    ]
+    if teste:
+        partes += [
+            f"const uint32_t CREDENCIAIS_TESTE_N = {len(unicos)};",
+            vetor_c("CREDENCIAIS_TESTE_IDS", unicos),
+            "",
+            vetor_c("CREDENCIAIS_TESTE_AUSENTES", ausentes(unicos, len(unicos), semente)),
+            "",
+        ]
+    return "\n".join(partes), len(chaves), bits, maior
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("lista", nargs="?", help="arquivo com um ID por linha")
+    ap.add_argument("-o", "--saida", required=True, help="arquivo .c gerado")
+    ap.add_argument("--aleatorios", type=int, metavar="N", help="sorteia N IDs em vez de ler a lista")
+    ap.add_argument("--semente", type=int, default=1)
+    ap.add_argument("--teste", action="store_true", help="inclui IDs presentes e ausentes para o benchmark")
+    args = ap.parse_args()
+
+    if args.aleatorios:
+        ids, origem = sortear(args.aleatorios, args.semente), f"{args.aleatorios} IDs sorteados (semente {args.semente})"
+    elif args.lista:
+        ids, origem = ler_lista(args.lista), args.lista.replace("\\", "/").split("/")[-1]
+    else:
+        ap.error("informe a lista ou --aleatorios")
+
+    codigo, n, bits, maior = gerar(ids, origem, args.teste, args.semente)
+    with open(args.saida, "w", encoding="utf-8") as f:
+        f.write(codigo)
+    print(f"{n} credenciais, {1 << bits} baldes, maior balde {maior} -> {args.saida}")
+
+
+if __name__ == "__main__":
+    main()
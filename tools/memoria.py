@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""Uso de flash e RAM por módulo, lido do mapa do linker (.elf.map).
+
+Cada seção de entrada que sobreviveu ao --gc-sections é atribuída ao objeto
+que a trouxe. O que está em endereço de flash conta como flash; o que está
+em RAM conta como RAM e, se a seção de saída tem "load address" (.data e
+afins, copiados da flash no boot), conta também como flash.
+
+    python3 tools/memoria.py build/LibraryAccessControl.elf.map [--todos]
+
+Sem --todos, os objetos do Pico SDK, do FreeRTOS e das bibliotecas (.a)
+aparecem somados por grupo; os da aplicação, um por linha.
+"""
+
+import argparse
+import os
+import re
+import sys
+from collections import defaultdict
+
+FLASH = (0x10000000, 0x11000000)
+RAM = (0x20000000, 0x20042000)
+
+# Seção de entrada: " .text.main  0x10000364  0x4c objeto" (o nome pode vir
+# sozinho numa linha, com endereço, tamanho e objeto na seguinte)
+ENTRADA = re.compile(r"^\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(\S.*)$")
+NOME_SECAO = re.compile(r"^ (\.\S+|COMMON)(?:\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(\S.*))?$")
+SAIDA = re.compile(r"^(\.\S+)\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)(.*)$")
+SAIDA_SO_NOME = re.compile(r"^(\.\S+)\s*$")
+
+
+def em(faixa, endereco):
+    return faixa[0] <= endereco < faixa[1]
+
+
+def grupo(objeto, todos):
+    """Nome com que o objeto aparece no relatório"""
+    caminho = objeto.replace("\\", "/")
+    nome = os.path.basename(caminho)
+    for sufixo in (".obj", ".o"):
+        if nome.endswith(sufixo):
+            nome = nome[: -len(sufixo)]
+    if todos:
+        return nome
+    if ".a(" in caminho:
+        return "bibliotecas (.a)"
+    if "FreeRTOS-Kernel" in caminho or "FreeRTOS_Kernel" in caminho:
+        return "FreeRTOS"
+    if "pico-sdk" in caminho or "pico_sdk" in caminho or "/rp2_common/" in caminho or "/common/" in caminho:
+        return "Pico SDK"
+    return nome
+
+
+def ler_mapa(arquivo, todos):
+    uso = defaultdict(lambda: [0, 0])  # módulo -> [flash, ram]
+    dentro = False
+    carregada = False  # Seção de saída atual é copiada da flash
+    pendente = None  # Nome de seção de entrada à espera da linha seguinte
+    esperando_saida = False
+
+    with open(arquivo, encoding="utf-8", errors="replace") as f:
+        for linha in f:
+            linha = linha.rstrip("\n")
+            if not dentro:
+                dentro = linha.startswith("Linker script and memory map")
+                continue
+
+            if esperando_saida:
+                esperando_saida = False
+                carregada = "load address" in linha
+                continue
+
+            m = SAIDA.match(linha)
+            if m:
+                carregada = "load address" in m.group(4)
+                pendente = None
+                continue
+            if SAIDA_SO_NOME.match(linha):
+                esperando_saida = True
+                pendente = None
+                continue
+
+            m = NOME_SECAO.match(linha)
+            if m:
+                if m.group(2) is None:
+                    pendente = m.group(1)
+                    continue
+                endereco, tamanho, objeto = m.group(2), m.group(3), m.group(4)
+            elif pendente:
+                m = ENTRADA.match(linha)
+                pendente = None
+                if not m:
+                    continue
+                endereco, tamanho, objeto = m.group(1), m.group(2), m.group(3)
+            else:
+                continue
+
+            endereco, tamanho = int(endereco, 16), int(tamanho, 16)
+            if tamanho == 0 or objeto.startswith("load address"):
+                continue
+            modulo = grupo(objeto.strip(), todos)
+            if em(FLASH, endereco):
+                uso[modulo][0] += tamanho
+            elif em(RAM, endereco):
+                uso[modulo][1] += tamanho
+                if carregada:
+                    uso[modulo][0] += tamanho
+    return uso
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("mapa")
+    ap.add_argument("--todos", action="store_true", help="um objeto por linha, sem agrupar")
+    args = ap.parse_args()
+
+    if not os.path.exists(args.mapa):
+        sys.exit(f"mapa não encontrado: {args.mapa}")
+    uso = ler_mapa(args.mapa, args.todos)
+
+    print(f"{'modulo':<32} {'flash':>9} {'ram':>9}")
+    total_flash = total_ram = 0
+    for modulo, (flash, ram) in sorted(uso.items(), key=lambda x: -(x[1][0] + x[1][1])):
+        print(f"{modulo:<32} {flash:>9} {ram:>9}")
+        total_flash += flash
+        total_ram += ram
+    print(f"{'total':<32} {total_flash:>9} {total_ram:>9}")
+
+
+if __name__ == "__main__":
+    main()